@@ -2,215 +2,90 @@
 #include <stdlib.h>
 #include <string.h>
 
-// Structure to represent a process
-struct Process {
-    int id;
-    int arrival_time;
-    int burst_time;
-    int priority;
-    int waiting_time;
-    int turnaround_time;
-    int completion_time;
+#include "sched.h"
+
+// The process set entered at the menu and a workspace sized for it.
+struct Workload {
+    struct Process *processes;
+    int n;
+    void *workspace;
 };
 
-// Global variables
-struct Process *processes = NULL;
-int n = 0;
+static void freeWorkload(struct Workload *workload) {
+    free(workload->processes);
+    free(workload->workspace);
+    workload->processes = NULL;
+    workload->workspace = NULL;
+    workload->n = 0;
+}
 
 // Function to input processes
-void enterProcesses() {
-    int i;
+void enterProcesses(struct Workload *workload) {
+    int i, n = 0;
 
     // Free previous memory if allocated
-    if (processes != NULL) {
-        free(processes);
-        processes = NULL;
-    }
+    freeWorkload(workload);
 
     printf("\nEnter number of processes: ");
     scanf("%d", &n);
 
     if (n <= 0) {
         printf("Invalid number of processes!\n");
-        n = 0;
         return;
     }
 
     // Allocate memory dynamically
-    processes = (struct Process*)malloc(n * sizeof(struct Process));
-    if (processes == NULL) {
+    workload->processes = (struct Process*)malloc(n * sizeof(struct Process));
+    workload->workspace = malloc(sched_workspace_size(n));
+    if (workload->processes == NULL || workload->workspace == NULL) {
         printf("Memory allocation failed!\n");
-        n = 0;
+        freeWorkload(workload);
         return;
     }
+    workload->n = n;
 
     printf("\nEnter process details:\n");
     for (i = 0; i < n; i++) {
-        processes[i].id = i + 1;
+        struct Process *process = &workload->processes[i];
+        memset(process, 0, sizeof(*process));
+        process->id = i + 1;
         printf("Process %d:\n", i + 1);
         printf("  Arrival Time: ");
-        scanf("%d", &processes[i].arrival_time);
+        scanf("%d", &process->arrival_time);
         printf("  Burst Time: ");
-        scanf("%d", &processes[i].burst_time);
+        scanf("%d", &process->burst_time);
         printf("  Priority (for Priority Scheduling): ");
-        scanf("%d", &processes[i].priority);
+        scanf("%d", &process->priority);
         printf("\n");
     }
     printf("Processes entered successfully!\n");
 }
 
-// Function to calculate FCFS
-void fcfs() {
-    int i;
-    if (n == 0) {
-        printf("Please enter processes first!\n");
-        return;
-    }
-
-    // Sort by arrival time
-    for (i = 0; i < n - 1; i++) {
-        for (int j = 0; j < n - i - 1; j++) {
-            if (processes[j].arrival_time > processes[j + 1].arrival_time) {
-                struct Process temp = processes[j];
-                processes[j] = processes[j + 1];
-                processes[j + 1] = temp;
-            }
-        }
-    }
-
-    // Calculate times
-    processes[0].completion_time = processes[0].arrival_time + processes[0].burst_time;
-    processes[0].turnaround_time = processes[0].completion_time - processes[0].arrival_time;
-    processes[0].waiting_time = processes[0].turnaround_time - processes[0].burst_time;
-
-    for (i = 1; i < n; i++) {
-        if (processes[i].arrival_time > processes[i-1].completion_time) {
-            processes[i].completion_time = processes[i].arrival_time + processes[i].burst_time;
-        } else {
-            processes[i].completion_time = processes[i-1].completion_time + processes[i].burst_time;
-        }
-        processes[i].turnaround_time = processes[i].completion_time - processes[i].arrival_time;
-        processes[i].waiting_time = processes[i].turnaround_time - processes[i].burst_time;
-    }
-}
-
-// Function to calculate SJF
-void sjf() {
-    int i;
-    if (n == 0) {
-        printf("Please enter processes first!\n");
-        return;
-    }
-
-    // Sort by burst time
-    for (i = 0; i < n - 1; i++) {
-        for (int j = 0; j < n - i - 1; j++) {
-            if (processes[j].burst_time > processes[j + 1].burst_time) {
-                struct Process temp = processes[j];
-                processes[j] = processes[j + 1];
-                processes[j + 1] = temp;
-            }
-        }
-    }
-
-    // Calculate times (similar to FCFS after sorting)
-    processes[0].completion_time = processes[0].arrival_time + processes[0].burst_time;
-    processes[0].turnaround_time = processes[0].completion_time - processes[0].arrival_time;
-    processes[0].waiting_time = processes[0].turnaround_time - processes[0].burst_time;
-
-    for (i = 1; i < n; i++) {
-        processes[i].completion_time = processes[i-1].completion_time + processes[i].burst_time;
-        processes[i].turnaround_time = processes[i].completion_time - processes[i].arrival_time;
-        processes[i].waiting_time = processes[i].turnaround_time - processes[i].burst_time;
-    }
-}
-
-// Function to calculate Priority Scheduling
-void priorityScheduling() {
-    int i;
-    if (n == 0) {
+// Runs the algorithm for menu choice 2-5 on the workload; results land in
+// its process array. time_quantum is only used by Round Robin.
+int runAlgorithm(struct Workload *workload, int algorithm, int time_quantum) {
+    if (workload->n == 0) {
         printf("Please enter processes first!\n");
-        return;
+        return 0;
     }
 
-    // Sort by priority (lower number = higher priority)
-    for (i = 0; i < n - 1; i++) {
-        for (int j = 0; j < n - i - 1; j++) {
-            if (processes[j].priority > processes[j + 1].priority) {
-                struct Process temp = processes[j];
-                processes[j] = processes[j + 1];
-                processes[j + 1] = temp;
+    switch (algorithm) {
+        case 2: return sched_fcfs(workload->processes, workload->n, workload->workspace) == SCHED_OK;
+        case 3: return sched_sjf(workload->processes, workload->n, workload->workspace) == SCHED_OK;
+        case 4:
+            if (sched_round_robin(workload->processes, workload->n, time_quantum,
+                                  workload->workspace) != SCHED_OK) {
+                printf("Invalid time quantum!\n");
+                return 0;
             }
-        }
-    }
-
-    // Calculate times
-    processes[0].completion_time = processes[0].arrival_time + processes[0].burst_time;
-    processes[0].turnaround_time = processes[0].completion_time - processes[0].arrival_time;
-    processes[0].waiting_time = processes[0].turnaround_time - processes[0].burst_time;
-
-    for (i = 1; i < n; i++) {
-        processes[i].completion_time = processes[i-1].completion_time + processes[i].burst_time;
-        processes[i].turnaround_time = processes[i].completion_time - processes[i].arrival_time;
-        processes[i].waiting_time = processes[i].turnaround_time - processes[i].burst_time;
+            return 1;
+        case 5: return sched_priority(workload->processes, workload->n, workload->workspace) == SCHED_OK;
     }
-}
-
-// Function to calculate Round Robin
-void roundRobin() {
-    int time_quantum, time = 0, completed = 0, i;
-    int *remaining_time;
-
-    if (n == 0) {
-        printf("Please enter processes first!\n");
-        return;
-    }
-
-    printf("Enter time quantum: ");
-    scanf("%d", &time_quantum);
-
-    if (time_quantum <= 0) {
-        printf("Invalid time quantum!\n");
-        return;
-    }
-
-    // Allocate memory for remaining times
-    remaining_time = (int*)malloc(n * sizeof(int));
-    if (remaining_time == NULL) {
-        printf("Memory allocation failed!\n");
-        return;
-    }
-
-    // Initialize remaining times
-    for (i = 0; i < n; i++) {
-        remaining_time[i] = processes[i].burst_time;
-        processes[i].completion_time = 0;
-    }
-
-    while (completed < n) {
-        for (i = 0; i < n; i++) {
-            if (remaining_time[i] > 0) {
-                if (remaining_time[i] > time_quantum) {
-                    time += time_quantum;
-                    remaining_time[i] -= time_quantum;
-                } else {
-                    time += remaining_time[i];
-                    processes[i].completion_time = time;
-                    processes[i].turnaround_time = processes[i].completion_time - processes[i].arrival_time;
-                    processes[i].waiting_time = processes[i].turnaround_time - processes[i].burst_time;
-                    remaining_time[i] = 0;
-                    completed++;
-                }
-            }
-        }
-    }
-
-    // Free allocated memory
-    free(remaining_time);
+    return 0;
 }
 
 // Function to display results
-void displayResults() {
+void displayResults(const struct Workload *workload) {
     int i;
     float avg_waiting = 0, avg_turnaround = 0;
 
@@ -218,22 +93,23 @@ void displayResults() {
     printf("PID\tArrival\tBurst\tPriority\tWaiting\tTurnaround\tCompletion\n");
     printf("------------------------------------------------------------------------\n");
 
-    for (i = 0; i < n; i++) {
+    for (i = 0; i < workload->n; i++) {
+        const struct Process *process = &workload->processes[i];
         printf("%d\t%d\t%d\t%d\t\t%d\t%d\t\t%d\n",
-               processes[i].id,
-               processes[i].arrival_time,
-               processes[i].burst_time,
-               processes[i].priority,
-               processes[i].waiting_time,
-               processes[i].turnaround_time,
-               processes[i].completion_time);
-
-        avg_waiting += processes[i].waiting_time;
-        avg_turnaround += processes[i].turnaround_time;
+               process->id,
+               process->arrival_time,
+               process->burst_time,
+               process->priority,
+               process->waiting_time,
+               process->turnaround_time,
+               process->completion_time);
+
+        avg_waiting += process->waiting_time;
+        avg_turnaround += process->turnaround_time;
     }
 
-    avg_waiting /= n;
-    avg_turnaround /= n;
+    avg_waiting /= workload->n;
+    avg_turnaround /= workload->n;
 
     printf("------------------------------------------------------------------------\n");
     printf("Average Waiting Time: %.2f\n", avg_waiting);
@@ -241,31 +117,40 @@ void displayResults() {
 }
 
 // Function to calculate average times
-void calculateAverages(float *avg_waiting, float *avg_turnaround) {
+void calculateAverages(const struct Workload *workload, float *avg_waiting, float *avg_turnaround) {
     int i;
     *avg_waiting = 0;
     *avg_turnaround = 0;
 
-    for (i = 0; i < n; i++) {
-        *avg_waiting += processes[i].waiting_time;
-        *avg_turnaround += processes[i].turnaround_time;
+    for (i = 0; i < workload->n; i++) {
+        *avg_waiting += workload->processes[i].waiting_time;
+        *avg_turnaround += workload->processes[i].turnaround_time;
     }
 
-    *avg_waiting /= n;
-    *avg_turnaround /= n;
+    *avg_waiting /= workload->n;
+    *avg_turnaround /= workload->n;
+}
+
+// Runs one algorithm for the comparison and prints its results. The
+// engines leave the input fields alone, so no backup copy is needed.
+static void compareOne(struct Workload *workload, const char *title, int algorithm, int time_quantum,
+                       float *avg_waiting, float *avg_turnaround) {
+    printf("\n--- %s ---\n", title);
+    runAlgorithm(workload, algorithm, time_quantum);
+    displayResults(workload);
+    calculateAverages(workload, avg_waiting, avg_turnaround);
 }
 
 // Function to compare all algorithms
-void compareAll() {
-    struct Process *original;
-    int i;
+void compareAll(struct Workload *workload) {
     float fcfs_waiting, fcfs_turnaround;
     float sjf_waiting, sjf_turnaround;
     float priority_waiting, priority_turnaround;
     float rr_waiting, rr_turnaround;
     int time_quantum = 2; // Default time quantum
+    char rr_title[64];
 
-    if (n == 0) {
+    if (workload->n == 0) {
         printf("Please enter processes first!\n");
         return;
     }
@@ -273,85 +158,11 @@ void compareAll() {
     printf("\n=== ALGORITHM COMPARISON ===\n");
     printf("Using default time quantum = 2 for Round Robin\n");
 
-    // Allocate memory for original data backup
-    original = (struct Process*)malloc(n * sizeof(struct Process));
-    if (original == NULL) {
-        printf("Memory allocation failed!\n");
-        return;
-    }
-
-    // Save original data
-    for (i = 0; i < n; i++) {
-        original[i] = processes[i];
-    }
-
-    // FCFS
-    printf("\n--- FCFS ---\n");
-    fcfs();
-    displayResults();
-    calculateAverages(&fcfs_waiting, &fcfs_turnaround);
-
-    // Restore original data
-    for (i = 0; i < n; i++) {
-        processes[i] = original[i];
-    }
-
-    // SJF
-    printf("\n--- SJF ---\n");
-    sjf();
-    displayResults();
-    calculateAverages(&sjf_waiting, &sjf_turnaround);
-
-    // Restore original data
-    for (i = 0; i < n; i++) {
-        processes[i] = original[i];
-    }
-
-    // Priority
-    printf("\n--- Priority Scheduling ---\n");
-    priorityScheduling();
-    displayResults();
-    calculateAverages(&priority_waiting, &priority_turnaround);
-
-    // Restore original data
-    for (i = 0; i < n; i++) {
-        processes[i] = original[i];
-    }
-
-    // Round Robin (simplified - use default quantum)
-    printf("\n--- Round Robin (Time Quantum = %d) ---\n", time_quantum);
-
-    // Simple Round Robin calculation for comparison
-    int time = 0, completed = 0;
-    int *remaining_time = (int*)malloc(n * sizeof(int));
-
-    // Initialize remaining times
-    for (i = 0; i < n; i++) {
-        remaining_time[i] = processes[i].burst_time;
-        processes[i].completion_time = 0;
-    }
-
-    while (completed < n) {
-        for (i = 0; i < n; i++) {
-            if (remaining_time[i] > 0) {
-                if (remaining_time[i] > time_quantum) {
-                    time += time_quantum;
-                    remaining_time[i] -= time_quantum;
-                } else {
-                    time += remaining_time[i];
-                    processes[i].completion_time = time;
-                    processes[i].turnaround_time = processes[i].completion_time - processes[i].arrival_time;
-                    processes[i].waiting_time = processes[i].turnaround_time - processes[i].burst_time;
-                    remaining_time[i] = 0;
-                    completed++;
-                }
-            }
-        }
-    }
-
-    free(remaining_time);
-    displayResults();
-    calculateAverages(&rr_waiting, &rr_turnaround);
+    compareOne(workload, "FCFS", 2, 0, &fcfs_waiting, &fcfs_turnaround);
+    compareOne(workload, "SJF", 3, 0, &sjf_waiting, &sjf_turnaround);
+    compareOne(workload, "Priority Scheduling", 5, 0, &priority_waiting, &priority_turnaround);
+    sprintf(rr_title, "Round Robin (Time Quantum = %d)", time_quantum);
+    compareOne(workload, rr_title, 4, time_quantum, &rr_waiting, &rr_turnaround);
 
     // Performance Summary
     printf("\n");
@@ -451,8 +262,6 @@ void compareAll() {
         printf("Note: Performance depends on time quantum selection.\n");
     }
 
-    // Free allocated memory
-    free(original);
 }
 
 // Function to display menu
@@ -475,6 +284,7 @@ void displayMenu() {
 }
 
 int main() {
+    struct Workload workload = {NULL, 0, NULL};
     int choice;
 
     while (1) {
@@ -483,37 +293,37 @@ int main() {
 
         switch (choice) {
             case 1:
-                enterProcesses();
+                enterProcesses(&workload);
                 break;
             case 2:
                 printf("\n--- First-Come, First-Served (FCFS) ---\n");
-                fcfs();
-                displayResults();
+                if (runAlgorithm(&workload, 2, 0)) displayResults(&workload);
                 break;
             case 3:
                 printf("\n--- Shortest Job First (SJF) ---\n");
-                sjf();
-                displayResults();
+                if (runAlgorithm(&workload, 3, 0)) displayResults(&workload);
                 break;
-            case 4:
+            case 4: {
+                int time_quantum = 0;
                 printf("\n--- Round Robin (RR) ---\n");
-                roundRobin();
-                displayResults();
+                if (workload.n > 0) {
+                    printf("Enter time quantum: ");
+                    scanf("%d", &time_quantum);
+                }
+                if (runAlgorithm(&workload, 4, time_quantum)) displayResults(&workload);
                 break;
+            }
             case 5:
                 printf("\n--- Priority Scheduling ---\n");
-                priorityScheduling();
-                displayResults();
+                if (runAlgorithm(&workload, 5, 0)) displayResults(&workload);
                 break;
             case 6:
-                compareAll();
+                compareAll(&workload);
                 break;
             case 7:
                 printf("\nThank you for using CPU Scheduler!\n");
                 // Free memory before exit
-                if (processes != NULL) {
-                    free(processes);
-                }
+                freeWorkload(&workload);
                 exit(0);
             default:
                 printf("\nInvalid choice! Please try again.\n");
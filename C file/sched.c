@@ -0,0 +1,232 @@
+#include "sched.h"
+
+enum ReadyOrder { READY_FIFO, READY_SHORTEST_BURST, READY_PRIORITY };
+
+// Ready queue over workspace memory: a ring of job indices for FIFO
+// order, otherwise a binary min-heap of (key, job) pairs.
+struct ReadyQueue {
+    int *slots;
+    int capacity;
+    int head;
+    int count;
+    enum ReadyOrder order;
+};
+
+static int keyOf(const struct Process *process, enum ReadyOrder order) {
+    return order == READY_SHORTEST_BURST ? process->burst_time : process->priority;
+}
+
+static int heapLess(const int *a, const int *b) {
+    return a[0] != b[0] ? a[0] < b[0] : a[1] < b[1];
+}
+
+static void heapSwap(int *a, int *b) {
+    int key = a[0], job = a[1];
+    a[0] = b[0];
+    a[1] = b[1];
+    b[0] = key;
+    b[1] = job;
+}
+
+static void readyPush(struct ReadyQueue *queue, const struct Process *processes, int job) {
+    int i;
+    if (queue->order == READY_FIFO) {
+        queue->slots[(queue->head + queue->count++) % queue->capacity] = job;
+        return;
+    }
+    i = queue->count++;
+    queue->slots[2 * i] = keyOf(&processes[job], queue->order);
+    queue->slots[2 * i + 1] = job;
+    while (i > 0 && heapLess(&queue->slots[2 * i], &queue->slots[2 * ((i - 1) / 2)])) {
+        heapSwap(&queue->slots[2 * i], &queue->slots[2 * ((i - 1) / 2)]);
+        i = (i - 1) / 2;
+    }
+}
+
+static int readyPop(struct ReadyQueue *queue) {
+    int job, i = 0;
+    if (queue->order == READY_FIFO) {
+        job = queue->slots[queue->head];
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->count--;
+        return job;
+    }
+    job = queue->slots[1];
+    queue->count--;
+    queue->slots[0] = queue->slots[2 * queue->count];
+    queue->slots[1] = queue->slots[2 * queue->count + 1];
+    for (;;) {
+        int smallest = i, left = 2 * i + 1, right = 2 * i + 2;
+        if (left < queue->count && heapLess(&queue->slots[2 * left], &queue->slots[2 * smallest])) smallest = left;
+        if (right < queue->count && heapLess(&queue->slots[2 * right], &queue->slots[2 * smallest])) smallest = right;
+        if (smallest == i) break;
+        heapSwap(&queue->slots[2 * i], &queue->slots[2 * smallest]);
+        i = smallest;
+    }
+    return job;
+}
+
+size_t sched_workspace_size(int n) {
+    // order, scratch and remaining times, plus two ints per queued job
+    return (size_t)(n > 0 ? n : 1) * 5 * sizeof(int);
+}
+
+void sched_sort_by_arrival(const struct Process *processes, int n, int *order, int *scratch) {
+    int *from = order, *to = scratch, *swap;
+    int i, shift;
+    for (i = 0; i < n; i++) order[i] = i;
+
+    for (shift = 0; shift < 32; shift += 8) {
+        int count[257] = {0};
+        unsigned first;
+        if (n == 0) break;
+        for (i = 0; i < n; i++) {
+            unsigned key = (unsigned)processes[i].arrival_time ^ 0x80000000u;
+            count[((key >> shift) & 0xFF) + 1]++;
+        }
+        first = ((unsigned)processes[0].arrival_time ^ 0x80000000u) >> shift & 0xFF;
+        if (count[first + 1] == n) continue;   // every key shares this byte
+        for (i = 0; i < 256; i++) count[i + 1] += count[i];
+        for (i = 0; i < n; i++) {
+            unsigned key = (unsigned)processes[from[i]].arrival_time ^ 0x80000000u;
+            to[count[(key >> shift) & 0xFF]++] = from[i];
+        }
+        swap = from;
+        from = to;
+        to = swap;
+    }
+    if (from != order) {
+        for (i = 0; i < n; i++) order[i] = from[i];
+    }
+}
+
+static void siftDown(int *a, int root, int end) {
+    for (;;) {
+        int child = 2 * root + 1, v;
+        if (child >= end) return;
+        if (child + 1 < end && a[child + 1] > a[child]) child++;
+        if (a[root] >= a[child]) return;
+        v = a[root];
+        a[root] = a[child];
+        a[child] = v;
+        root = child;
+    }
+}
+
+// Insertion sort for the usual handful of jobs, heapsort beyond that.
+static void sortIndices(int *a, int k) {
+    int i, j, v;
+    if (k <= 16) {
+        for (i = 1; i < k; i++) {
+            v = a[i];
+            for (j = i; j > 0 && a[j - 1] > v; j--) a[j] = a[j - 1];
+            a[j] = v;
+        }
+        return;
+    }
+    for (i = k / 2 - 1; i >= 0; i--) siftDown(a, i, k);
+    for (i = k - 1; i > 0; i--) {
+        v = a[0];
+        a[0] = a[i];
+        a[i] = v;
+        siftDown(a, 0, i);
+    }
+}
+
+struct Engine {
+    struct Process *processes;
+    int n;
+    int *order;          // stable arrival order
+    int *released;       // jobs released by one release() call
+    int *remaining;
+    int next_arrival;
+    int release_by_index;
+    long long time;
+    struct ReadyQueue queue;
+};
+
+// Queues every job that has arrived by now.
+static void release(struct Engine *engine) {
+    int count = 0, i;
+    while (engine->next_arrival < engine->n &&
+           engine->processes[engine->order[engine->next_arrival]].arrival_time <= engine->time) {
+        engine->released[count++] = engine->order[engine->next_arrival++];
+    }
+    if (engine->release_by_index && count > 1) sortIndices(engine->released, count);
+    for (i = 0; i < count; i++) readyPush(&engine->queue, engine->processes, engine->released[i]);
+}
+
+// The one event-driven loop behind every algorithm. With an empty ready
+// queue the clock jumps to the next arrival; time_quantum 0 runs each job
+// to completion. Jobs released together queue in input order, except for
+// FCFS, which keeps the stable arrival order.
+static int schedule(struct Process *processes, int n, enum ReadyOrder ready_order, int time_quantum,
+                    int release_by_index, void *workspace) {
+    struct Engine engine;
+    int i, completed = 0;
+
+    if (processes == NULL || workspace == NULL || n < 0 || time_quantum < 0) return SCHED_EINVAL;
+    if (n == 0) return SCHED_OK;
+
+    engine.processes = processes;
+    engine.n = n;
+    engine.order = (int*)workspace;
+    engine.released = engine.order + n;
+    engine.remaining = engine.released + n;
+    engine.next_arrival = 0;
+    engine.release_by_index = release_by_index;
+    engine.time = 0;
+    engine.queue.slots = engine.remaining + n;
+    engine.queue.capacity = n;
+    engine.queue.head = 0;
+    engine.queue.count = 0;
+    engine.queue.order = ready_order;
+
+    sched_sort_by_arrival(processes, n, engine.order, engine.released);
+    for (i = 0; i < n; i++) engine.remaining[i] = processes[i].burst_time;
+
+    release(&engine);
+    while (completed < n) {
+        int job, slice;
+        if (engine.queue.count == 0) {
+            engine.time = processes[engine.order[engine.next_arrival]].arrival_time;
+            release(&engine);
+            continue;
+        }
+
+        job = readyPop(&engine.queue);
+        slice = engine.remaining[job];
+        if (time_quantum > 0 && slice > time_quantum) slice = time_quantum;
+        engine.time += slice;
+        engine.remaining[job] -= slice;
+        release(&engine);   // arrivals during the slice queue ahead of a preempted job
+
+        if (engine.remaining[job] > 0) {
+            readyPush(&engine.queue, processes, job);
+        } else {
+            struct Process *process = &processes[job];
+            process->completion_time = (int)engine.time;
+            process->turnaround_time = process->completion_time - process->arrival_time;
+            process->waiting_time = process->turnaround_time - process->burst_time;
+            completed++;
+        }
+    }
+    return SCHED_OK;
+}
+
+int sched_fcfs(struct Process *processes, int n, void *workspace) {
+    return schedule(processes, n, READY_FIFO, 0, 0, workspace);
+}
+
+int sched_sjf(struct Process *processes, int n, void *workspace) {
+    return schedule(processes, n, READY_SHORTEST_BURST, 0, 0, workspace);
+}
+
+int sched_priority(struct Process *processes, int n, void *workspace) {
+    return schedule(processes, n, READY_PRIORITY, 0, 0, workspace);
+}
+
+int sched_round_robin(struct Process *processes, int n, int time_quantum, void *workspace) {
+    if (time_quantum <= 0) return SCHED_EINVAL;
+    return schedule(processes, n, READY_FIFO, time_quantum, 1, workspace);
+}
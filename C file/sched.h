@@ -0,0 +1,56 @@
+/*
+ * Reentrant CPU scheduling library.
+ *
+ * No global state and no allocation: the caller owns the process array and
+ * a workspace of sched_workspace_size(n) bytes (any malloc'd or static
+ * buffer; int alignment is enough), so several schedules can run at once
+ * on different threads. Arrivals are radix sorted once and the engines are
+ * event driven, so every algorithm is O(n log n).
+ *
+ * Results are written into the caller's array in its original order and
+ * match the C++ engines (scheduler_core.h) with free context switches:
+ * jobs that become ready at the same time queue in input order, SJF and
+ * Priority break ties on the earlier entry, and Round Robin requeues a
+ * preempted job behind the jobs that arrived during its slice.
+ */
+
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Structure to represent a process
+struct Process {
+    int id;
+    int arrival_time;
+    int burst_time;
+    int priority;          // lower number = higher priority
+    int waiting_time;
+    int turnaround_time;
+    int completion_time;
+};
+
+#define SCHED_OK      0
+#define SCHED_EINVAL -1    // null pointer, n < 0 or time quantum <= 0
+
+// Bytes of workspace the engines need for n processes.
+size_t sched_workspace_size(int n);
+
+int sched_fcfs(struct Process *processes, int n, void *workspace);
+int sched_sjf(struct Process *processes, int n, void *workspace);
+int sched_priority(struct Process *processes, int n, void *workspace);
+int sched_round_robin(struct Process *processes, int n, int time_quantum, void *workspace);
+
+// Writes the indices of processes in stable arrival order to order[n],
+// using scratch[n]. LSD radix sort, O(n).
+void sched_sort_by_arrival(const struct Process *processes, int n, int *order, int *scratch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,92 @@
+// Benchmark driver for the scheduling library: times every algorithm on
+// random workloads of growing size and prints nanoseconds per job.
+//
+//   sched_bench [max_jobs]      (default 1000000)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "sched.h"
+
+// xorshift32, so the workloads are the same on every platform
+static unsigned nextRandom(unsigned *state) {
+    unsigned x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+// Arrivals spread over roughly the total work, so the CPU stays busy and
+// the ready queue holds a real backlog.
+static void generate(struct Process *processes, int n, unsigned seed) {
+    int i;
+    for (i = 0; i < n; i++) {
+        processes[i].id = i + 1;
+        processes[i].arrival_time = (int)(nextRandom(&seed) % ((unsigned)n * 5));
+        processes[i].burst_time = 1 + (int)(nextRandom(&seed) % 10);
+        processes[i].priority = (int)(nextRandom(&seed) % 8);
+        processes[i].waiting_time = processes[i].turnaround_time = processes[i].completion_time = 0;
+    }
+}
+
+static double seconds(void) {
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char *argv[]) {
+    int max_jobs = argc > 1 ? atoi(argv[1]) : 1000000;
+    const char *names[] = {"FCFS", "SJF", "Round Robin (q=4)", "Priority"};
+    struct Process *processes;
+    void *workspace;
+    int n, algorithm;
+
+    if (max_jobs <= 0) {
+        printf("Usage: %s [max_jobs]\n", argv[0]);
+        return 1;
+    }
+
+    processes = (struct Process*)malloc(max_jobs * sizeof(struct Process));
+    workspace = malloc(sched_workspace_size(max_jobs));
+    if (processes == NULL || workspace == NULL) {
+        printf("Memory allocation failed!\n");
+        return 1;
+    }
+
+    printf("%-20s %10s %12s %12s %14s\n", "Algorithm", "Jobs", "Time (ms)", "ns/job", "Avg Waiting");
+    printf("-----------------------------------------------------------------------\n");
+    for (n = 1000; ; n *= 10) {
+        if (n > max_jobs) n = max_jobs;
+        for (algorithm = 0; algorithm < 4; algorithm++) {
+            int i, reps = 0, status = SCHED_OK;
+            double start, elapsed, waiting = 0;
+
+            generate(processes, n, 12345u + n);
+            start = seconds();
+            do {   // repeat small workloads until the timing is meaningful
+                switch (algorithm) {
+                    case 0: status = sched_fcfs(processes, n, workspace); break;
+                    case 1: status = sched_sjf(processes, n, workspace); break;
+                    case 2: status = sched_round_robin(processes, n, 4, workspace); break;
+                    case 3: status = sched_priority(processes, n, workspace); break;
+                }
+                reps++;
+                elapsed = seconds() - start;
+            } while (status == SCHED_OK && elapsed < 0.2);
+            if (status != SCHED_OK) {
+                printf("%s failed on %d jobs\n", names[algorithm], n);
+                return 1;
+            }
+
+            for (i = 0; i < n; i++) waiting += processes[i].waiting_time;
+            printf("%-20s %10d %12.3f %12.1f %14.2f\n", names[algorithm], n,
+                   elapsed * 1000 / reps, elapsed * 1e9 / reps / n, waiting / n);
+        }
+        if (n == max_jobs) break;
+    }
+
+    free(workspace);
+    free(processes);
+    return 0;
+}
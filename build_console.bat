@@ -5,7 +5,7 @@ echo ========================================
 echo.
 
 echo Building console version...
-g++ -std=c++11 -O2 -o cpu_scheduler_console.exe console_main.cpp
+g++ -std=c++11 -O2 -pthread -o cpu_scheduler_console.exe console_main.cpp
 
 if %ERRORLEVEL% EQU 0 (
     echo.
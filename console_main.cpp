@@ -11,230 +11,4304 @@
 #include <vector>
 #include <algorithm>
 #include <queue>
+#include <deque>
 #include <iomanip>
+#include <sstream>
 #include <climits>
+#include <set>
+#include <unordered_map>
+#include <numeric>
+#include <functional>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <string>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <new>
+#include <stdexcept>
+#if defined(__linux__)
+#include <pthread.h>
+#elif defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+#include "scheduler_core.h"
 
 using namespace std;
 
-struct Process {
-    int id;
-    int arrivalTime;
-    int burstTime;
-    int priority;
-    int waitingTime;
-    int turnaroundTime;
-    int completionTime;
-    int remainingTime;
-    
-    Process(int i, int at, int bt, int p = 0) 
-        : id(i), arrivalTime(at), burstTime(bt), priority(p),
-          waitingTime(0), turnaroundTime(0), completionTime(0), remainingTime(bt) {}
+// Compact binary image of an engine's state for checkpoint/restore. Values
+// are stored raw in host byte order, so a snapshot is resumed by the same
+// build. The header ties it to the workload and parameters it came from.
+class Snapshot {
+public:
+    Snapshot() : readPos(0) {}
+
+    template <typename T>
+    void put(const T& value) {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        data.insert(data.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    void putVector(const vector<T>& values) {
+        put<unsigned long long>(values.size());
+        const char* bytes = reinterpret_cast<const char*>(values.data());
+        data.insert(data.end(), bytes, bytes + values.size() * sizeof(T));
+    }
+
+    template <typename T>
+    bool get(T& value) {
+        if (readPos + sizeof(T) > data.size()) return false;
+        copy(data.begin() + readPos, data.begin() + readPos + sizeof(T), reinterpret_cast<char*>(&value));
+        readPos += sizeof(T);
+        return true;
+    }
+
+    template <typename T>
+    bool getVector(vector<T>& values) {
+        unsigned long long count;
+        if (!get(count) || readPos + count * sizeof(T) > data.size()) return false;
+        values.resize(count);
+        copy(data.begin() + readPos, data.begin() + readPos + count * sizeof(T),
+             reinterpret_cast<char*>(values.data()));
+        readPos += count * sizeof(T);
+        return true;
+    }
+
+    void putHeader(unsigned long long fingerprint) {
+        unsigned long long magic = MAGIC;
+        data.clear();
+        put(magic);
+        put(fingerprint);
+    }
+
+    bool checkHeader(unsigned long long fingerprint) {
+        unsigned long long magic, stored;
+        readPos = 0;
+        return get(magic) && magic == MAGIC && get(stored) && stored == fingerprint;
+    }
+
+    static const unsigned long long FNV_OFFSET = 1469598103934665603ULL;
+
+    // one FNV-1a step per byte of value
+    static void mix(unsigned long long& hash, long long value) {
+        for (int b = 0; b < 8; b++) {
+            hash = (hash ^ ((value >> (8 * b)) & 0xff)) * 1099511628211ULL;
+        }
+    }
+
+    // Hash of the workload inputs and engine parameters
+    static unsigned long long fingerprint(const vector<Process>& processes, const vector<long long>& params) {
+        unsigned long long hash = FNV_OFFSET;
+        for (size_t i = 0; i < params.size(); i++) mix(hash, params[i]);
+        for (const auto& process : processes) {
+            mix(hash, process.id);
+            mix(hash, process.arrivalTime);
+            mix(hash, process.burstTime);
+            mix(hash, process.priority);
+            mix(hash, process.deadline);
+            mix(hash, process.period);
+        }
+        return hash;
+    }
+
+    // Written next to the target and renamed over it, so a crash mid-write
+    // leaves the previous snapshot intact.
+    bool save(const string& path) const {
+        string temp = path + ".tmp";
+        {
+            ofstream out(temp.c_str(), ios::binary | ios::trunc);
+            if (!out.write(data.data(), data.size())) return false;
+        }
+        if (rename(temp.c_str(), path.c_str()) != 0) {
+            remove(path.c_str());
+            return rename(temp.c_str(), path.c_str()) == 0;
+        }
+        return true;
+    }
+
+    bool load(const string& path) {
+        ifstream in(path.c_str(), ios::binary);
+        if (!in) return false;
+        data.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        readPos = 0;
+        return true;
+    }
+
+private:
+    static const unsigned long long MAGIC = 0x3150414e53555043ULL;   // "CPUSNAP1"
+
+    vector<char> data;
+    size_t readPos;
+};
+
+// Where and how often an engine snapshots itself, in simulated time.
+struct CheckpointOptions {
+    string path;
+    long long interval;   // 0 = no snapshots
+    bool resume;          // continue from the snapshot at path if it matches
+
+    CheckpointOptions() : interval(0), resume(false) {}
+
+    bool due(long long now, long long& nextCheckpoint) const {
+        if (interval <= 0 || now < nextCheckpoint) return false;
+        nextCheckpoint = (now / interval + 1) * interval;
+        return true;
+    }
+};
+
+// Streams slices as Chrome Trace Event JSON (chrome://tracing, Perfetto UI):
+// one trace process per engine run, one thread track per core, one time
+// unit per microsecond. Output goes through a fixed buffer, so memory stays
+// constant however long the timeline.
+class TraceWriter : public SliceSink {
+public:
+    static const size_t BUFFER_SIZE = 1 << 20;
+
+    TraceWriter() : file(0), used(0), runs(0), first(true) {}
+    ~TraceWriter() { close(); }
+
+    bool open(const string& path) {
+        close();
+        file = fopen(path.c_str(), "wb");
+        if (!file) return false;
+        buffer.resize(BUFFER_SIZE);
+        used = 0;
+        runs = 0;
+        first = true;
+        write("{\"traceEvents\": [\n");
+        return true;
+    }
+
+    bool isOpen() const { return file != 0; }
+
+    void close() {
+        if (!file) return;
+        write("\n]}\n");
+        flush();
+        fclose(file);
+        file = 0;
+    }
+
+    void beginRun(const char* engine) {
+        if (!file) return;
+        runs++;
+        namedCores.clear();
+        separator();
+        write("{\"ph\": \"M\", \"name\": \"process_name\", \"pid\": ");
+        writeNumber(runs);
+        write(", \"args\": {\"name\": \"");
+        writeNumber(runs);
+        write(". ");
+        write(engine);
+        write("\"}}");
+    }
+
+    void slice(const GanttEntry& entry) {
+        if (!file) return;
+        if (entry.core >= (int)namedCores.size()) namedCores.resize(entry.core + 1, false);
+        if (!namedCores[entry.core]) {
+            namedCores[entry.core] = true;
+            separator();
+            write("{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": ");
+            writeNumber(runs);
+            write(", \"tid\": ");
+            writeNumber(entry.core);
+            write(", \"args\": {\"name\": \"CPU ");
+            writeNumber(entry.core);
+            write("\"}}");
+        }
+        separator();
+        write(entry.isSwitch ? "{\"ph\": \"X\", \"cat\": \"switch\", \"name\": \"switch P"
+                             : "{\"ph\": \"X\", \"cat\": \"run\", \"name\": \"P");
+        writeNumber(entry.processId);
+        write("\", \"pid\": ");
+        writeNumber(runs);
+        write(", \"tid\": ");
+        writeNumber(entry.core);
+        write(", \"ts\": ");
+        writeNumber(entry.startTime);
+        write(", \"dur\": ");
+        writeNumber(entry.endTime - entry.startTime);
+        write("}");
+    }
+
+private:
+    FILE* file;
+    vector<char> buffer;
+    size_t used;
+    long long runs;
+    bool first;
+    vector<bool> namedCores;
+
+    void flush() {
+        fwrite(buffer.data(), 1, used, file);
+        used = 0;
+    }
+
+    void write(const char* text) {
+        for (; *text; text++) {
+            if (used == buffer.size()) flush();
+            buffer[used++] = *text;
+        }
+    }
+
+    void writeNumber(long long value) {
+        char digits[24];
+        char* end = digits + sizeof(digits);
+        char* p = end;
+        unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long)value : value;
+        do {
+            *--p = (char)('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude);
+        if (value < 0) *--p = '-';
+        if (buffer.size() - used < sizeof(digits)) flush();
+        memcpy(&buffer[used], p, end - p);
+        used += end - p;
+    }
+
+    void separator() {
+        write(first ? "" : ",\n");
+        first = false;
+    }
+};
+
+// Appends every result table of the session to a CSV file: one row per
+// job, then an ALL row per run holding the averages and the schedule-wide
+// metrics, which job rows leave empty.
+class ResultsCsv {
+public:
+    ResultsCsv() : runs(0) {}
+
+    static ResultsCsv*& active() {
+        static ResultsCsv* csv = 0;
+        return csv;
+    }
+
+    bool open(const string& path) {
+        out.open(path.c_str());
+        if (!out) return false;
+        out << fixed << setprecision(4);
+        out << "run,algorithm,process,arrival,burst,completion,waiting,turnaround,response,slowdown,"
+               "max_waiting,throughput,window,peak_window_jobs,low_window_jobs,cpu_utilization,fairness\n";
+        return true;
+    }
+
+    void write(const vector<Process>& processes, const string& algorithm, const ScheduleMetrics& metrics) {
+        if (!out.is_open()) return;
+        runs++;
+        string name = "\"";
+        for (char c : algorithm) name += c == '"' ? string("\"\"") : string(1, c);
+        name += "\"";
+        for (const auto& process : processes) {
+            out << runs << ',' << name << ",P" << process.id << ',' << process.arrivalTime << ','
+                << process.burstTime << ',' << process.completionTime << ',' << process.waitingTime << ','
+                << process.turnaroundTime << ',' << process.responseTime() << ',' << process.slowdown()
+                << ",,,,,,,\n";
+        }
+        out << runs << ',' << name << ",ALL,,,," << metrics.averageWaiting << ',' << metrics.averageTurnaround
+            << ',' << metrics.averageResponse << ',' << metrics.averageSlowdown << ',' << metrics.maxWaiting << ','
+            << metrics.throughput << ',' << metrics.window << ',' << metrics.peakWindowJobs << ','
+            << metrics.lowWindowJobs << ',';
+        if (metrics.cpuUtilization >= 0) out << metrics.cpuUtilization;
+        out << ',' << metrics.fairness << "\n";
+        out.flush();
+    }
+
+private:
+    ofstream out;
+    long long runs;
+};
+
+// Deadline accounting for the real-time engines. Lateness is kept as a
+// log2 histogram so memory stays fixed no matter how many instances run.
+struct DeadlineStats {
+    static const int LATENESS_BUCKETS = 32;
+
+    long long instances;
+    long long misses;
+    long long totalLateness;
+    long long maxLateness;
+    long long latenessHistogram[LATENESS_BUCKETS];   // [0] on time, [k] lateness in [2^(k-1), 2^k), the last open-ended
+
+    DeadlineStats() : instances(0), misses(0), totalLateness(0), maxLateness(0) {
+        fill(latenessHistogram, latenessHistogram + LATENESS_BUCKETS, 0LL);
+    }
+
+    void record(long long lateness) {
+        instances++;
+        if (lateness <= 0) {
+            latenessHistogram[0]++;
+            return;
+        }
+        int bucket = 1;
+        while (bucket < LATENESS_BUCKETS - 1 && (1LL << bucket) <= lateness) {
+            bucket++;
+        }
+        latenessHistogram[bucket]++;
+        misses++;
+        totalLateness += lateness;
+        maxLateness = max(maxLateness, lateness);
+    }
+
+    double missRatio() const {
+        return instances == 0 ? 0.0 : (double)misses / instances;
+    }
+
+    double averageLateness() const {
+        return misses == 0 ? 0.0 : (double)totalLateness / misses;
+    }
+};
+
+// CPU/I-O burst sequences for all jobs in one flat array: job i owns
+// lengths[offsets[i] .. offsets[i + 1]), alternating CPU, I/O, CPU, ...
+// starting with a CPU burst. devices holds the device of each I/O slot
+// and -1 for CPU slots.
+struct BurstTable {
+    vector<int> offsets;
+    vector<int> lengths;
+    vector<int> devices;
+
+    BurstTable() : offsets(1, 0) {}
+
+    void addCpuBurst(int length) {
+        lengths.push_back(length);
+        devices.push_back(-1);
+    }
+
+    void addIoBurst(int length, int device) {
+        lengths.push_back(length);
+        devices.push_back(device);
+    }
+
+    void endJob() {
+        offsets.push_back(lengths.size());
+    }
+
+    int jobCount() const {
+        return offsets.size() - 1;
+    }
+
+    bool isCpuSlot(int slot, int job) const {
+        return (slot - offsets[job]) % 2 == 0;
+    }
+
+    unsigned long long fingerprint() const {
+        unsigned long long hash = Snapshot::FNV_OFFSET;
+        for (size_t i = 0; i < offsets.size(); i++) Snapshot::mix(hash, offsets[i]);
+        for (size_t i = 0; i < lengths.size(); i++) {
+            Snapshot::mix(hash, lengths[i]);
+            Snapshot::mix(hash, devices[i]);
+        }
+        return hash;
+    }
+};
+
+// Next-CPU-burst prediction by exponential averaging, one model per
+// recurring task (jobs sharing a process id): tau(n+1) = alpha * t(n) +
+// (1 - alpha) * tau(n), starting from initialBurst. The model is one
+// float per task and each observed burst updates it in O(1), after
+// scoring the prediction it replaces.
+class BurstPredictor {
+public:
+    BurstPredictor(double alpha = 0.5, double initialBurst = 10)
+        : alpha(alpha), initialBurst(initialBurst) {
+        clearErrors();
+    }
+
+    // Maps each job to its task slot and starts every task at initialBurst.
+    void reset(const vector<Process>& processes) {
+        unordered_map<int, int> slotOf;
+        taskOf.resize(processes.size());
+        for (size_t i = 0; i < processes.size(); i++) {
+            taskOf[i] = slotOf.insert(make_pair(processes[i].id, (int)slotOf.size())).first->second;
+        }
+        tau.assign(slotOf.size(), (float)initialBurst);
+        clearErrors();
+    }
+
+    double predict(int job) const {
+        return tau[taskOf[job]];
+    }
+
+    void observe(int job, int burst) {
+        float& estimate = tau[taskOf[job]];
+        double error = estimate - burst;
+        observations++;
+        absoluteError += fabs(error);
+        squaredError += error * error;
+        signedError += error;
+        estimate = (float)(alpha * burst + (1 - alpha) * estimate);
+    }
+
+    int taskCount() const { return tau.size(); }
+    long long observationCount() const { return observations; }
+
+    double meanAbsoluteError() const {
+        return observations == 0 ? 0.0 : absoluteError / observations;
+    }
+
+    double rootMeanSquaredError() const {
+        return observations == 0 ? 0.0 : sqrt(squaredError / observations);
+    }
+
+    // positive when bursts are overestimated
+    double bias() const {
+        return observations == 0 ? 0.0 : signedError / observations;
+    }
+
+    void save(Snapshot& snapshot) const {
+        snapshot.putVector(tau);
+        snapshot.put(observations);
+        snapshot.put(absoluteError);
+        snapshot.put(squaredError);
+        snapshot.put(signedError);
+    }
+
+    bool load(Snapshot& snapshot) {
+        return snapshot.getVector(tau) && snapshot.get(observations) && snapshot.get(absoluteError) &&
+               snapshot.get(squaredError) && snapshot.get(signedError);
+    }
+
+    double alpha;
+    double initialBurst;
+
+private:
+    void clearErrors() {
+        observations = 0;
+        absoluteError = squaredError = signedError = 0;
+    }
+
+    vector<int> taskOf;
+    vector<float> tau;
+    long long observations;
+    double absoluteError;
+    double squaredError;
+    double signedError;
+};
+
+// Busy time per resource over the makespan of a burst-sequence run.
+struct UtilizationStats {
+    long long makespan;
+    long long cpuBusy;
+    vector<long long> deviceBusy;
+    vector<long long> deviceQueueWait;
+    vector<long long> deviceRequests;
+
+    UtilizationStats() : makespan(0), cpuBusy(0) {}
+
+    double cpuUtilization() const {
+        return makespan == 0 ? 0.0 : (double)cpuBusy / makespan;
+    }
+
+    double deviceUtilization(int device) const {
+        return makespan == 0 ? 0.0 : (double)deviceBusy[device] / makespan;
+    }
+};
+
+// Core-time accounting of a gang-scheduling run. Fragmentation is idle
+// core time while jobs were waiting: cores left over because no queued
+// gang fitted in them.
+struct GangStats {
+    int cores;
+    long long makespan;
+    long long busyCoreTime;
+    long long fragmentationIdle;
+    int backfilled;   // jobs started ahead of an earlier-queued gang
+
+    GangStats() : cores(0), makespan(0), busyCoreTime(0), fragmentationIdle(0), backfilled(0) {}
+
+    long long idleCoreTime() const { return (long long)cores * makespan - busyCoreTime; }
+
+    double utilization() const {
+        return makespan == 0 ? 0.0 : (double)busyCoreTime / ((double)cores * makespan);
+    }
+};
+
+enum CpuPolicy { POLICY_FCFS, POLICY_SJF, POLICY_RR, POLICY_PRIORITY, POLICY_SJF_PREDICTED, POLICY_SRTF_PREDICTED };
+
+// One DVFS operating point: speed relative to the top frequency (work
+// done per ms) and the power drawn while running at it.
+struct FrequencyLevel {
+    double speed;
+    double watts;
+};
+
+// A core's frequency levels, fastest first. Bursts are measured at the top
+// level; at speed s a slice of w units takes ceil(w / s) ms. The default
+// levels follow P = staticWatts + dynamicWatts * s^3 (voltage scaling with
+// frequency), evenly spaced from 1 down to minSpeed.
+struct DvfsModel {
+    vector<FrequencyLevel> levels;
+    double idleWatts;
+    double maxStretch;   // energy-aware: a slice may take (1 + maxStretch) x its top-speed time...
+    int stretchBacklog;  // ...while at most this many jobs wait, so a backlog always drains at full speed
+
+    DvfsModel(int count = 4, double minSpeed = 0.4, double staticWatts = 1.0, double dynamicWatts = 9.0,
+              double idle = 0.5, double stretch = 0, int backlog = 2)
+        : idleWatts(idle), maxStretch(stretch), stretchBacklog(backlog) {
+        count = max(1, count);
+        for (int i = 0; i < count; i++) {
+            double speed = count == 1 ? 1.0 : 1.0 - (1.0 - minSpeed) * i / (count - 1);
+            FrequencyLevel level = {speed, staticWatts + dynamicWatts * speed * speed * speed};
+            levels.push_back(level);
+        }
+    }
+};
+
+// PERFORMANCE always runs at the top level. ENERGY_AWARE runs each slice at
+// the level that spends the least energy (busy plus idle power) within its
+// slack: the gap to the next arrival when nothing else is ready, else
+// maxStretch while the backlog is short, and never past the job's deadline.
+enum DvfsGovernor { GOVERNOR_PERFORMANCE, GOVERNOR_ENERGY_AWARE };
+
+struct EnergyStats {
+    long long makespan;
+    long long busyTime;      // execution plus switch overhead
+    long long stretchTime;   // execution time beyond what the top level needs
+    double busyJoules;
+    double idleJoules;
+    vector<long long> levelTime;   // ms executed at each level
+
+    EnergyStats() : makespan(0), busyTime(0), stretchTime(0), busyJoules(0), idleJoules(0) {}
+
+    double joules() const { return busyJoules + idleJoules; }
+    double energyDelayProduct() const { return joules() * makespan / 1000.0; }   // J*s
+    double averageWatts() const { return makespan == 0 ? 0.0 : joules() * 1000.0 / makespan; }
+};
+
+// Entry of the future-event list; ordered by time, then insertion order.
+struct SimEvent {
+    enum Type { ARRIVAL, CPU_DONE, IO_DONE };
+
+    long long time;
+    long long seq;
+    int type;
+    int job;
+
+    SimEvent() : time(0), seq(0), type(ARRIVAL), job(0) {}
+    SimEvent(long long t, long long s, int ty, int j) : time(t), seq(s), type(ty), job(j) {}
+
+    bool operator>(const SimEvent& other) const {
+        return time != other.time ? time > other.time : seq > other.seq;
+    }
+};
+
+enum EventQueueKind { EVENT_QUEUE_HEAP, EVENT_QUEUE_CALENDAR, EVENT_QUEUE_WHEEL };
+
+// Future-event list behind the event-driven engines. Every implementation
+// pops in (time, seq) order, so results never depend on which one is used.
+// Pushed events must not be earlier than the last popped one.
+class EventQueue {
+public:
+    virtual ~EventQueue() {}
+    virtual void push(const SimEvent& event) = 0;
+    virtual const SimEvent& top() = 0;
+    virtual void pop() = 0;
+    virtual bool empty() const = 0;
+    virtual void collect(vector<SimEvent>& events) const = 0;   // pending events, any order
+
+    static unique_ptr<EventQueue> create(EventQueueKind kind);
+};
+
+// Baseline: binary heap, O(log n) push and pop.
+class HeapEventQueue : public EventQueue {
+public:
+    void push(const SimEvent& event) {
+        heap.push_back(event);
+        push_heap(heap.begin(), heap.end(), greater<SimEvent>());
+    }
+    const SimEvent& top() { return heap.front(); }
+    void pop() {
+        pop_heap(heap.begin(), heap.end(), greater<SimEvent>());
+        heap.pop_back();
+    }
+    bool empty() const { return heap.empty(); }
+    void collect(vector<SimEvent>& events) const { events.insert(events.end(), heap.begin(), heap.end()); }
+
+private:
+    vector<SimEvent> heap;
+};
+
+// Pooled singly linked nodes for the bucketed queues, so steady-state
+// push/pop never touches the allocator.
+class EventNodePool {
+public:
+    struct Node {
+        SimEvent event;
+        int next;
+    };
+
+    int allocate(const SimEvent& event) {
+        if (freeList < 0) {
+            Node node = {event, -1};
+            nodes.push_back(node);
+            return nodes.size() - 1;
+        }
+        int idx = freeList;
+        freeList = nodes[idx].next;
+        nodes[idx].event = event;
+        nodes[idx].next = -1;
+        return idx;
+    }
+
+    void release(int idx) {
+        nodes[idx].next = freeList;
+        freeList = idx;
+    }
+
+    Node& operator[](int idx) { return nodes[idx]; }
+    const Node& operator[](int idx) const { return nodes[idx]; }
+
+    EventNodePool() : freeList(-1) {}
+
+private:
+    vector<Node> nodes;
+    int freeList;
+};
+
+// Brown's calendar queue: a ring of day-wide buckets, each a sorted list.
+// The bucket count doubles/halves with the population and the day width is
+// re-estimated from the spacing of the earliest events, which keeps a few
+// events per bucket and gives amortized O(1) push and pop.
+class CalendarEventQueue : public EventQueue {
+public:
+    CalendarEventQueue() : count(0), width(1), lastBucket(0), bucketTop(1), lastTime(0), found(-1) {
+        head.assign(MIN_BUCKETS, -1);
+        tail.assign(MIN_BUCKETS, -1);
+    }
+
+    void push(const SimEvent& event) {
+        insert(pool.allocate(event));
+        count++;
+        found = -1;
+        if (count > 2 * head.size()) resize(head.size() * 2);
+    }
+
+    const SimEvent& top() {
+        locate();
+        return pool[head[found]].event;
+    }
+
+    void pop() {
+        locate();
+        int idx = head[found];
+        head[found] = pool[idx].next;
+        if (head[found] < 0) tail[found] = -1;
+        lastBucket = found;
+        bucketTop = foundTop;
+        lastTime = pool[idx].event.time;
+        pool.release(idx);
+        count--;
+        found = -1;
+        if (head.size() > MIN_BUCKETS && count < head.size() / 2) resize(head.size() / 2);
+    }
+
+    bool empty() const { return count == 0; }
+
+    void collect(vector<SimEvent>& events) const {
+        for (size_t b = 0; b < head.size(); b++) {
+            for (int idx = head[b]; idx >= 0; idx = pool[idx].next) events.push_back(pool[idx].event);
+        }
+    }
+
+private:
+    static const size_t MIN_BUCKETS = 16;
+    static const int WIDTH_SAMPLE = 25;
+
+    int bucketOf(long long time) const {
+        return (int)((time / width) & (head.size() - 1));
+    }
+
+    void insert(int idx) {
+        const SimEvent& event = pool[idx].event;
+        int b = bucketOf(event.time);
+        if (head[b] < 0) {
+            head[b] = tail[b] = idx;
+            pool[idx].next = -1;
+        } else if (!(pool[tail[b]].event > event)) {
+            // common case: later than everything in the bucket
+            pool[tail[b]].next = idx;
+            pool[idx].next = -1;
+            tail[b] = idx;
+        } else if (pool[head[b]].event > event) {
+            pool[idx].next = head[b];
+            head[b] = idx;
+        } else {
+            int prev = head[b];
+            while (!(pool[pool[prev].next].event > event)) prev = pool[prev].next;
+            pool[idx].next = pool[prev].next;
+            pool[prev].next = idx;
+        }
+    }
+
+    // Finds the bucket holding the earliest event without moving the
+    // calendar, so a push between top() and pop() is still ordered.
+    void locate() {
+        if (found >= 0) return;
+        int mask = head.size() - 1;
+        int b = lastBucket;
+        long long top = bucketTop;
+        for (size_t k = 0; k < head.size(); k++) {
+            if (head[b] >= 0 && pool[head[b]].event.time < top) {
+                found = b;
+                foundTop = top;
+                return;
+            }
+            b = (b + 1) & mask;
+            top += width;
+        }
+
+        // sparse year: fall back to a direct search over bucket heads
+        int best = -1;
+        for (size_t i = 0; i < head.size(); i++) {
+            if (head[i] >= 0 && (best < 0 || pool[head[best]].event > pool[head[i]].event)) best = i;
+        }
+        found = best;
+        foundTop = (pool[head[best]].event.time / width + 1) * width;
+    }
+
+    void resize(size_t buckets) {
+        vector<int> nodes;
+        nodes.reserve(count);
+        for (size_t b = 0; b < head.size(); b++) {
+            for (int idx = head[b]; idx >= 0; idx = pool[idx].next) nodes.push_back(idx);
+        }
+
+        // day width: three times the mean gap between the earliest events
+        size_t sample = min<size_t>(WIDTH_SAMPLE, nodes.size());
+        if (sample > 1) {
+            auto earlier = [&](int a, int b) { return pool[b].event > pool[a].event; };
+            nth_element(nodes.begin(), nodes.begin() + (sample - 1), nodes.end(), earlier);
+            sort(nodes.begin(), nodes.begin() + sample, earlier);
+            long long span = pool[nodes[sample - 1]].event.time - pool[nodes[0]].event.time;
+            width = max(1LL, 3 * span / (long long)(sample - 1));
+        }
+
+        head.assign(buckets, -1);
+        tail.assign(buckets, -1);
+        for (size_t i = 0; i < nodes.size(); i++) insert(nodes[i]);
+
+        lastBucket = bucketOf(lastTime);
+        bucketTop = (lastTime / width + 1) * width;
+        found = -1;
+    }
+
+    EventNodePool pool;
+    vector<int> head, tail;
+    size_t count;
+    long long width;
+    int lastBucket;
+    long long bucketTop;   // end of the day lastBucket currently stands for
+    long long lastTime;
+    int found;
+    long long foundTop;
+};
+
+// Hierarchical timing wheel: four 256-slot levels cover 2^32 time units
+// ahead of the cursor; an event sits at the level of the highest byte in
+// which its time differs from the cursor, and whole slots cascade down as
+// the cursor reaches them. Level-0 slots hold a single timestamp in FIFO
+// (= seq) order. Events beyond the wheel's reach wait in an overflow heap.
+class TimingWheelEventQueue : public EventQueue {
+public:
+    TimingWheelEventQueue() : now(0), count(0), cached(-1) {
+        for (int level = 0; level < LEVELS; level++) {
+            fill(head[level], head[level] + SLOTS, -1);
+            fill(tail[level], tail[level] + SLOTS, -1);
+            fill(occupied[level], occupied[level] + SLOTS / 64, 0ULL);
+        }
+    }
+
+    void push(const SimEvent& event) {
+        count++;
+        cached = -1;
+        if (((event.time ^ now) >> (SLOT_BITS * LEVELS)) != 0) {
+            overflow.push_back(event);
+            push_heap(overflow.begin(), overflow.end(), greater<SimEvent>());
+            return;
+        }
+        place(pool.allocate(event));
+    }
+
+    // Peeks without advancing the cursor, since the simulation may still
+    // push events earlier than the next one.
+    const SimEvent& top() {
+        if (cached >= 0) return pool[cached].event;
+        for (int level = 0; level < LEVELS; level++) {
+            int slot = nextOccupied(level, digit(now, level) + (level == 0 ? 0 : 1));
+            if (slot < 0) continue;
+            // a level-0 slot is one timestamp in seq order; higher slots are unsorted
+            int best = head[level][slot];
+            for (int idx = level == 0 ? -1 : pool[best].next; idx >= 0; idx = pool[idx].next) {
+                if (pool[best].event > pool[idx].event) best = idx;
+            }
+            cached = best;
+            return pool[best].event;
+        }
+        return overflow.front();
+    }
+
+    void pop() {
+        cached = -1;
+        count--;
+        while (true) {
+            int slot0 = (int)(now & (SLOTS - 1));
+            if (head[0][slot0] >= 0) {
+                int idx = head[0][slot0];
+                unlinkHead(0, slot0);
+                pool.release(idx);
+                return;
+            }
+
+            int slot = nextOccupied(0, slot0 + 1);
+            if (slot >= 0) {
+                now = (now & ~(long long)(SLOTS - 1)) | slot;
+                continue;
+            }
+
+            bool advanced = false;
+            for (int level = 1; level < LEVELS && !advanced; level++) {
+                slot = nextOccupied(level, digit(now, level) + 1);
+                if (slot < 0) continue;
+                int shift = SLOT_BITS * (level + 1);
+                now = ((now >> shift) << shift) | ((long long)slot << (SLOT_BITS * level));
+                cascade(level, slot);
+                advanced = true;
+            }
+            if (advanced) continue;
+
+            // wheel is empty: jump to the overflow and pull in what now fits
+            now = overflow.front().time;
+            while (!overflow.empty() && ((overflow.front().time ^ now) >> (SLOT_BITS * LEVELS)) == 0) {
+                place(pool.allocate(overflow.front()));
+                pop_heap(overflow.begin(), overflow.end(), greater<SimEvent>());
+                overflow.pop_back();
+            }
+        }
+    }
+
+    bool empty() const { return count == 0; }
+
+    void collect(vector<SimEvent>& events) const {
+        for (int level = 0; level < LEVELS; level++) {
+            for (int slot = 0; slot < SLOTS; slot++) {
+                for (int idx = head[level][slot]; idx >= 0; idx = pool[idx].next) events.push_back(pool[idx].event);
+            }
+        }
+        events.insert(events.end(), overflow.begin(), overflow.end());
+    }
+
+private:
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 8;
+    static const int SLOTS = 1 << SLOT_BITS;
+
+    static int digit(long long time, int level) {
+        return (int)((time >> (SLOT_BITS * level)) & (SLOTS - 1));
+    }
+
+    void place(int idx) {
+        long long time = max(pool[idx].event.time, now);
+        long long diff = time ^ now;
+        int level = 0;
+        while (level < LEVELS - 1 && (diff >> (SLOT_BITS * (level + 1))) != 0) level++;
+        int slot = digit(time, level);
+        pool[idx].next = -1;
+        if (head[level][slot] < 0) {
+            head[level][slot] = idx;
+            occupied[level][slot / 64] |= 1ULL << (slot % 64);
+        } else {
+            pool[tail[level][slot]].next = idx;
+        }
+        tail[level][slot] = idx;
+    }
+
+    void unlinkHead(int level, int slot) {
+        head[level][slot] = pool[head[level][slot]].next;
+        if (head[level][slot] < 0) {
+            tail[level][slot] = -1;
+            occupied[level][slot / 64] &= ~(1ULL << (slot % 64));
+        }
+    }
+
+    void cascade(int level, int slot) {
+        int idx = head[level][slot];
+        head[level][slot] = tail[level][slot] = -1;
+        occupied[level][slot / 64] &= ~(1ULL << (slot % 64));
+        while (idx >= 0) {
+            int next = pool[idx].next;
+            place(idx);
+            idx = next;
+        }
+    }
+
+    int nextOccupied(int level, int from) const {
+        for (int word = from / 64; word < SLOTS / 64; word++) {
+            unsigned long long bits = occupied[level][word];
+            if (word == from / 64) bits &= ~0ULL << (from % 64);
+            if (bits != 0) return word * 64 + __builtin_ctzll(bits);
+        }
+        return -1;
+    }
+
+    EventNodePool pool;
+    int head[LEVELS][SLOTS];
+    int tail[LEVELS][SLOTS];
+    unsigned long long occupied[LEVELS][SLOTS / 64];
+    vector<SimEvent> overflow;   // min-heap
+    long long now;
+    size_t count;
+    int cached;
+};
+
+unique_ptr<EventQueue> EventQueue::create(EventQueueKind kind) {
+    switch (kind) {
+        case EVENT_QUEUE_CALENDAR: return unique_ptr<EventQueue>(new CalendarEventQueue());
+        case EVENT_QUEUE_WHEEL:    return unique_ptr<EventQueue>(new TimingWheelEventQueue());
+        default:                   return unique_ptr<EventQueue>(new HeapEventQueue());
+    }
+}
+
+#if ENGINE_COUNTERS
+// Heap traffic is counted at the source, for whichever run is open on the
+// allocating thread.
+// Both sides stay out of line so GCC does not pair an inlined malloc with
+// the replacement delete and flag it as mismatched.
+__attribute__((noinline)) void* operator new(size_t bytes) {
+    EngineCounters::current().allocated(bytes);
+    if (void* p = malloc(bytes ? bytes : 1)) return p;
+    throw bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void* operator new[](size_t bytes) {
+    return operator new(bytes);
+}
+
+void operator delete[](void* p) noexcept {
+    operator delete(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    operator delete(p);
+}
+#endif
+
+// Wraps an ordering so each comparison made by a heap or tree is counted.
+template <typename Compare>
+struct CountedCompare : Compare {
+    template <typename T>
+    bool operator()(const T& a, const T& b) const {
+        EngineCounters::current().compare();
+        return Compare::operator()(a, b);
+    }
+};
+
+class CPUScheduler {
+public:
+    static vector<Process> fcfs(const vector<Process>& processes,
+                                const SwitchCostModel& costModel = SwitchCostModel()) {
+        vector<Process> result;
+        fcfs(processes, result, costModel);
+        return result;
+    }
+    
+    // The fcfs/sjf/roundRobin/priority overloads taking `result` write into
+    // it, reusing its capacity, and draw scratch from the thread's
+    // SimulationContext: a caller that keeps `result` allocates nothing.
+    static void fcfs(const vector<Process>& processes, vector<Process>& result,
+                     const SwitchCostModel& costModel = SwitchCostModel()) {
+        EngineCounters::Run run("fcfs");
+        {
+            SimulationContext::Scope scratch;
+            int n = processes.size();
+            const int* order = sortedByArrival(processes);
+            result.resize(n);
+            for (int k = 0; k < n; k++) result[k] = processes[order[k]];
+        }
+        FcfsEngine::run(result, RunToCompletion(), costModel, "FCFS");
+    }
+
+    // FCFS as a blocked max-plus prefix scan. Each job is the map
+    // x -> max(x, arrival) + cost, and such maps compose associatively, so
+    // chunks summarise themselves in parallel, a short serial pass carries
+    // the finish time across chunks, and a second parallel pass fills in
+    // the results. Integer arithmetic throughout: identical to fcfs().
+    static vector<Process> parallelFcfs(vector<Process> processes, int threads = 0,
+                                        const SwitchCostModel& costModel = SwitchCostModel()) {
+        // a trace needs slices in time order, which only the serial engine emits
+        if (SliceSink::active()) return fcfs(processes, costModel);
+        
+        EngineCounters::Run run("parallelFcfs");
+        EngineCounters::Phase phase("scan");
+        size_t n = processes.size();
+        if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+        int chunks = (int)min<size_t>(threads, max<size_t>(1, n / PARALLEL_FCFS_MIN_CHUNK));
+        
+        // Every FCFS dispatch switches to a job that has never run.
+        int overhead = costModel.switchCost + costModel.cacheRefill(-1);
+        vector<long long> reach(chunks), shift(chunks);   // chunk map: x -> max(x + shift, reach)
+        vector<char> sorted(chunks);
+        
+        forEachChunk(n, chunks, [&](int c, size_t begin, size_t end) {
+            long long r = LLONG_MIN / 2, s = 0;
+            bool inOrder = true;
+            for (size_t i = begin; i < end; i++) {
+                const Process& p = processes[i];
+                if (i > begin && p.arrivalTime < processes[i - 1].arrivalTime) inOrder = false;
+                long long cost = overhead + p.burstTime;
+                r = max(r, (long long)p.arrivalTime) + cost;
+                s += cost;
+            }
+            reach[c] = r;
+            shift[c] = s;
+            sorted[c] = inOrder;
+        });
+        
+        bool inOrder = true;
+        for (int c = 0; c < chunks; c++) {
+            size_t begin = n * c / chunks;
+            if (!sorted[c] || (c > 0 && begin < n &&
+                               processes[begin].arrivalTime < processes[begin - 1].arrivalTime)) {
+                inOrder = false;
+            }
+        }
+        if (!inOrder) {
+            phase.next("sort");
+            sortByArrival(processes, threads);
+            return parallelFcfs(processes, threads, costModel);
+        }
+        
+        phase.next("carry");
+        vector<long long> carry(chunks);
+        long long finish = 0;
+        for (int c = 0; c < chunks; c++) {
+            carry[c] = finish;
+            finish = max(finish + shift[c], reach[c]);
+        }
+        
+        phase.next("fill");
+        EngineCounters::current().slice(n);
+        forEachChunk(n, chunks, [&](int c, size_t begin, size_t end) {
+            long long currentTime = carry[c];
+            for (size_t i = begin; i < end; i++) {
+                Process& process = processes[i];
+                currentTime = max(currentTime, (long long)process.arrivalTime);
+                process.waitingTime = (int)(currentTime - process.arrivalTime);
+                process.firstRunTime = (int)currentTime;
+                process.remainingTime = 0;
+                process.contextSwitches++;
+                process.switchTime += costModel.switchCost;
+                process.cacheRefillTime += overhead - costModel.switchCost;
+                currentTime += overhead + process.burstTime;
+                process.completionTime = (int)currentTime;
+                process.turnaroundTime = process.completionTime - process.arrivalTime;
+            }
+        });
+        
+        return processes;
+    }
+    
+    static vector<Process> sjf(const vector<Process>& processes,
+                               const SwitchCostModel& costModel = SwitchCostModel()) {
+        vector<Process> result;
+        sjf(processes, result, costModel);
+        return result;
+    }
+    
+    static void sjf(const vector<Process>& input, vector<Process>& processes,
+                  const SwitchCostModel& costModel = SwitchCostModel()) {
+        EngineCounters::Run run("sjf");
+        processes = input;
+        SjfEngine::run(processes, RunToCompletion(), costModel, "SJF");
+    }
+    
+    static vector<Process> roundRobin(const vector<Process>& processes, int timeQuantum,
+                                      const SwitchCostModel& costModel = SwitchCostModel()) {
+        vector<Process> result;
+        roundRobin(processes, result, timeQuantum, costModel);
+        return result;
+    }
+    
+    static void roundRobin(const vector<Process>& input, vector<Process>& processes, int timeQuantum,
+                           const SwitchCostModel& costModel = SwitchCostModel()) {
+        EngineCounters::Run run("roundRobin");
+        processes = input;
+        RoundRobinEngine::run(processes, QuantumExpiry(timeQuantum), costModel, "Round Robin");
+    }
+    
+    // Round robin with the quantum reset every round to `percentile` of the
+    // queued jobs' remaining times (50 = median); each change is appended
+    // to `trajectory`, if given.
+    static vector<Process> adaptiveRoundRobin(vector<Process> processes, double percentile,
+                                              vector<QuantumStep>* trajectory = 0,
+                                              const SwitchCostModel& costModel = SwitchCostModel()) {
+        EngineCounters::Run run("adaptiveRoundRobin");
+        AdaptiveRoundRobinEngine::run(processes, percentile, costModel, trajectory);
+        return processes;
+    }
+    
+    static vector<Process> priority(const vector<Process>& processes,
+                                    const SwitchCostModel& costModel = SwitchCostModel()) {
+        vector<Process> result;
+        priority(processes, result, costModel);
+        return result;
+    }
+    
+    static void priority(const vector<Process>& input, vector<Process>& processes,
+                       const SwitchCostModel& costModel = SwitchCostModel()) {
+        EngineCounters::Run run("priority");
+        processes = input;
+        PriorityEngine::run(processes, RunToCompletion(), costModel, "Priority");
+    }
+    
+    static vector<Process> cfs(vector<Process> processes, int targetLatency = 6, int minGranularity = 1,
+                               const SwitchCostModel& costModel = SwitchCostModel(),
+                               const CheckpointOptions& checkpoint = CheckpointOptions()) {
+        // Linux sched_prio_to_weight, indexed by nice + 20
+        static const int niceToWeight[40] = {
+            88761, 71755, 56483, 46273, 36291,
+            29154, 23254, 18705, 14949, 11916,
+             9548,  7620,  6100,  4904,  3906,
+             3121,  2501,  1991,  1586,  1277,
+             1024,   820,   655,   526,   423,
+              335,   272,   215,   172,   137,
+              110,    87,    70,    56,    45,
+               36,    29,    23,    18,    15
+        };
+        const long long NICE_0_LOAD = 1024;
+        const int VRUNTIME_SHIFT = 10;   // extra fixed-point precision for vruntime
+        typedef set<pair<long long, int>, CountedCompare<less<pair<long long, int>>>> VruntimeTree;
+
+        EngineCounters::Run run("cfs");
+        EngineCounters& counters = EngineCounters::current();
+        SimulationContext::Scope scratch;   // arrival order and SwitchTracker state
+        EngineCounters::Phase phase("setup");
+        if (minGranularity <= 0) minGranularity = 1;
+        if (targetLatency < minGranularity) targetLatency = minGranularity;
+
+        int n = processes.size();
+        const int* order = sortedByArrival(processes);
+
+        // priority doubles as the nice value (lower number = higher priority)
+        vector<long long> weight(n);
+        vector<long long> vruntime(n, 0);
+        for (int i = 0; i < n; i++) {
+            int nice = max(-20, min(19, processes[i].priority));
+            weight[i] = niceToWeight[nice + 20];
+            processes[i].remainingTime = processes[i].burstTime;
+        }
+
+        // runtime -> vruntime, scaled so heavy jobs still advance on 1-unit slices
+        auto vdelta = [&](int idx, long long delta) {
+            return (delta * NICE_0_LOAD << VRUNTIME_SHIFT) / weight[idx];
+        };
+        const long long wakeupGranularity = (long long)minGranularity << VRUNTIME_SHIFT;
+
+        VruntimeTree tree;   // (vruntime, index), leftmost runs next
+        long long totalWeight = 0;
+        long long minVruntime = 0;
+        int nextArrival = 0;
+
+        auto enqueueArrivals = [&](long long upTo) {
+            while (nextArrival < n && processes[order[nextArrival]].arrivalTime <= upTo) {
+                int idx = order[nextArrival++];
+                counters.arrivalScan();
+                counters.push();
+                vruntime[idx] = max(vruntime[idx], minVruntime);
+                tree.insert(make_pair(vruntime[idx], idx));
+                totalWeight += weight[idx];
+            }
+        };
+
+        SwitchTracker switches(costModel, n, "CFS");
+        long long currentTime = 0;   // 64-bit: fine-grained clocks pass 2^31 within the hour
+        int completedCount = 0;
+        auto stored = [](long long time) {
+            if (time > INT_MAX || time < INT_MIN) {
+                throw overflow_error("CFS time " + to_string(time) + " does not fit the 32-bit Process fields");
+            }
+            return (int)time;
+        };
+
+        unsigned long long fingerprint = Snapshot::fingerprint(processes,
+            checkpointParams(ENGINE_CFS, costModel, targetLatency, minGranularity));
+        Snapshot snapshot;
+        long long nextCheckpoint = checkpoint.interval;
+
+        if (checkpoint.resume) {
+            vector<Process> input = processes;
+            vector<pair<long long, int>> treeNodes;
+            bool restored = snapshot.load(checkpoint.path) && snapshot.checkHeader(fingerprint) &&
+                            snapshot.getVector(processes) && snapshot.getVector(vruntime) &&
+                            snapshot.getVector(treeNodes) && snapshot.get(totalWeight) &&
+                            snapshot.get(minVruntime) && snapshot.get(nextArrival) &&
+                            snapshot.get(currentTime) && snapshot.get(completedCount) &&
+                            switches.load(snapshot);
+            if (!restored) {
+                return cfs(input, targetLatency, minGranularity, costModel, restartFromScratch(checkpoint));
+            }
+            tree = VruntimeTree(treeNodes.begin(), treeNodes.end());
+            nextCheckpoint = nextCheckpointAfter(currentTime, checkpoint);
+        }
+
+        phase.next("simulate");
+        while (completedCount < n) {
+            if (checkpoint.due(currentTime, nextCheckpoint)) {
+                snapshot.putHeader(fingerprint);
+                snapshot.putVector(processes);
+                snapshot.putVector(vruntime);
+                snapshot.putVector(vector<pair<long long, int>>(tree.begin(), tree.end()));
+                snapshot.put(totalWeight);
+                snapshot.put(minVruntime);
+                snapshot.put(nextArrival);
+                snapshot.put(currentTime);
+                snapshot.put(completedCount);
+                switches.save(snapshot);
+                snapshot.save(checkpoint.path);
+            }
+
+            enqueueArrivals(currentTime);
+
+            if (tree.empty()) {
+                counters.idleTick(processes[order[nextArrival]].arrivalTime - currentTime);
+                currentTime = processes[order[nextArrival]].arrivalTime;
+                continue;
+            }
+
+            int currentIdx = tree.begin()->second;
+            tree.erase(tree.begin());
+            counters.pop();
+            counters.slice();
+            Process& currentProcess = processes[currentIdx];
+
+            // sched_period stretches once there are more jobs than fit in the latency target
+            long long nrRunning = tree.size() + 1;
+            long long period = targetLatency;
+            if (nrRunning > targetLatency / minGranularity) {
+                period = nrRunning * minGranularity;
+            }
+            long long slice = max<long long>(minGranularity, period * weight[currentIdx] / totalWeight);
+
+            // jobs arriving while the switch is paid wait for the next pick
+            currentTime += switches.dispatch(currentProcess, currentIdx, currentTime);
+            enqueueArrivals(currentTime);
+
+            long long startTime = currentTime;
+            long long endTime = startTime + min<long long>(slice, currentProcess.remainingTime);
+
+            // wakeup preemption: a woken job with sufficiently smaller vruntime cuts the
+            // slice short (check_preempt_wakeup); jobs already waiting don't
+            while (nextArrival < n && processes[order[nextArrival]].arrivalTime < endTime) {
+                int arrival = processes[order[nextArrival]].arrivalTime;
+                long long runningVruntime = vruntime[currentIdx] + vdelta(currentIdx, arrival - startTime);
+                minVruntime = max(minVruntime, tree.empty() ? runningVruntime
+                                               : min(runningVruntime, tree.begin()->first));
+                int firstWoken = nextArrival;
+                enqueueArrivals(arrival);
+                long long wokenVruntime = LLONG_MAX;
+                for (int k = firstWoken; k < nextArrival; k++) {
+                    wokenVruntime = min(wokenVruntime, vruntime[order[k]]);
+                }
+                if (runningVruntime - wokenVruntime > wakeupGranularity) {
+                    endTime = arrival;
+                    break;
+                }
+            }
+
+            int execTime = (int)(endTime - startTime);
+            currentTime = endTime;
+            currentProcess.remainingTime -= execTime;
+            vruntime[currentIdx] += vdelta(currentIdx, execTime);
+            switches.stop(currentIdx, currentTime);
+
+            if (currentProcess.remainingTime == 0) {
+                long long turnaround = currentTime - currentProcess.arrivalTime;
+                currentProcess.completionTime = stored(currentTime);
+                currentProcess.turnaroundTime = stored(turnaround);
+                currentProcess.waitingTime = stored(turnaround - currentProcess.burstTime -
+                                                    currentProcess.switchOverhead());
+                totalWeight -= weight[currentIdx];
+                completedCount++;
+            } else {
+                counters.push();
+                tree.insert(make_pair(vruntime[currentIdx], currentIdx));
+            }
+
+            // min_vruntime only moves forward
+            if (!tree.empty()) {
+                minVruntime = max(minVruntime, tree.begin()->first);
+            }
+        }
+
+        return processes;
+    }
+    
+    // Preemptive Earliest Deadline First. Periodic jobs release a new
+    // instance every period until the horizon.
+    static vector<Process> edf(vector<Process> processes, int horizon, DeadlineStats& stats,
+                               const SwitchCostModel& costModel = SwitchCostModel(),
+                               const CheckpointOptions& checkpoint = CheckpointOptions()) {
+        return realTime(processes, horizon, true, stats, costModel, checkpoint);
+    }
+    
+    // Preemptive rate-monotonic: fixed priority, shorter period runs first.
+    // One-shot jobs rank by their deadline, or last if they have none.
+    static vector<Process> rateMonotonic(vector<Process> processes, int horizon, DeadlineStats& stats,
+                                         const SwitchCostModel& costModel = SwitchCostModel(),
+                                         const CheckpointOptions& checkpoint = CheckpointOptions()) {
+        return realTime(processes, horizon, false, stats, costModel, checkpoint);
+    }
+    
+    // Least common multiple of all periods, offset by the latest arrival,
+    // saturating at INT_MAX. Returns 0 when there are no periodic jobs.
+    static int hyperperiod(const vector<Process>& processes) {
+        long long lcm = 0;
+        int latestArrival = 0;
+        for (const auto& process : processes) {
+            latestArrival = max(latestArrival, process.arrivalTime);
+            if (process.period <= 0) continue;
+            if (lcm == 0) {
+                lcm = process.period;
+            } else {
+                long long a = lcm, b = process.period;
+                while (b != 0) {
+                    long long t = a % b;
+                    a = b;
+                    b = t;
+                }
+                lcm = min<long long>(INT_MAX, lcm / a * process.period);
+            }
+        }
+        if (lcm == 0) return 0;
+        return (int)min<long long>(INT_MAX, lcm + latestArrival);
+    }
+    
+    // Event-driven simulation of jobs that alternate CPU and I/O bursts.
+    // The CPU picks from the ready queue by policy (FCFS, shortest next
+    // CPU burst, round robin, or priority; only RR preempts), and each of
+    // numDevices devices serves its I/O requests FCFS. burstTime in the
+    // results is the job's total CPU demand and waitingTime its total time
+    // in the CPU ready queue.
+    //
+    // The predicted policies don't read burst lengths ahead: SJF orders on
+    // the predictor's estimate of the next burst, and SRTF on the estimate
+    // less what the burst has run so far, preempting the running job when
+    // a job becomes ready with a smaller one. Keys are taken when a job
+    // becomes ready. Every finished CPU burst is fed to the predictor
+    // (an internal alpha 0.5 one when none is given), whatever the policy.
+    static vector<Process> burstSequences(vector<Process> processes, const BurstTable& bursts,
+                                          int numDevices, CpuPolicy policy, int timeQuantum,
+                                          UtilizationStats& stats,
+                                          const SwitchCostModel& costModel = SwitchCostModel(),
+                                          EventQueueKind queueKind = EVENT_QUEUE_HEAP,
+                                          const CheckpointOptions& checkpoint = CheckpointOptions(),
+                                          BurstPredictor* predictor = 0) {
+        typedef pair<pair<long long, long long>, int> ReadyEntry;   // ((key, seq), job)
+        typedef CountedCompare<greater<ReadyEntry>> ReadyAfter;
+
+        EngineCounters::Run run("burstSequences");
+        EngineCounters& counters = EngineCounters::current();
+        SimulationContext::Scope scratch;   // SwitchTracker state
+        EngineCounters::Phase phase("setup");
+        int n = processes.size();
+        vector<int> slot(n);
+        vector<long long> remaining(n), readySince(n), ioSince(n);
+        long long seq = 0;
+
+        unique_ptr<EventQueue> eventList = EventQueue::create(queueKind);
+        EventQueue& events = *eventList;
+        vector<ReadyEntry> ready;   // min-heap
+        vector<deque<int>> deviceQueue(numDevices);
+        vector<int> deviceJob(numDevices, -1);
+        BurstPredictor fallback;
+        BurstPredictor& model = predictor ? *predictor : fallback;
+        model.reset(processes);
+
+        stats = UtilizationStats();
+        stats.deviceBusy.assign(numDevices, 0);
+        stats.deviceQueueWait.assign(numDevices, 0);
+        stats.deviceRequests.assign(numDevices, 0);
+
+        for (int i = 0; i < n; i++) {
+            slot[i] = bursts.offsets[i];
+            processes[i].burstTime = 0;
+            for (int k = bursts.offsets[i]; k < bursts.offsets[i + 1]; k += 2) {
+                processes[i].burstTime += bursts.lengths[k];
+            }
+            processes[i].remainingTime = processes[i].burstTime;
+            processes[i].waitingTime = 0;
+        }
+
+        auto pushReady = [&](long long key, int i) {
+            counters.push();
+            ready.push_back(ReadyEntry(make_pair(key, seq++), i));
+            push_heap(ready.begin(), ready.end(), ReadyAfter());
+        };
+        // predicted time left in the current burst, in 1/1024 ms
+        auto predictedKey = [&](int i, long long ran) {
+            double executed = bursts.lengths[slot[i]] - remaining[i] + ran;
+            return (long long)(max(0.0, model.predict(i) - executed) * 1024);
+        };
+        auto makeReady = [&](int i, long long now) {
+            remaining[i] = bursts.lengths[slot[i]];
+            readySince[i] = now;
+            long long key = seq;
+            if (policy == POLICY_SJF) key = remaining[i];
+            else if (policy == POLICY_PRIORITY) key = processes[i].priority;
+            else if (policy == POLICY_SJF_PREDICTED || policy == POLICY_SRTF_PREDICTED) key = predictedKey(i, 0);
+            pushReady(key, i);
+        };
+        auto startIo = [&](int device, long long now) {
+            int i = deviceQueue[device].front();
+            deviceQueue[device].pop_front();
+            deviceJob[device] = i;
+            stats.deviceQueueWait[device] += now - ioSince[i];
+            stats.deviceBusy[device] += bursts.lengths[slot[i]];
+            events.push(SimEvent(now + bursts.lengths[slot[i]], seq++, SimEvent::IO_DONE, device));
+        };
+        // the job's current slot is finished: move to its next burst or complete
+        auto advance = [&](int i, long long now) {
+            if (++slot[i] == bursts.offsets[i + 1]) {
+                processes[i].completionTime = (int)now;
+                processes[i].turnaroundTime = processes[i].completionTime - processes[i].arrivalTime;
+                processes[i].remainingTime = 0;
+                stats.makespan = max(stats.makespan, now);
+            } else if (bursts.isCpuSlot(slot[i], i)) {
+                makeReady(i, now);
+            } else {
+                int device = bursts.devices[slot[i]];
+                ioSince[i] = now;
+                stats.deviceRequests[device]++;
+                deviceQueue[device].push_back(i);
+                if (deviceJob[device] < 0) startIo(device, now);
+            }
+        };
+
+        SwitchTracker switches(costModel, n, "CPU/I-O Bursts");
+        int running = -1;
+        long long runLength = 0;
+        long long runStart = 0;
+        long long runSeq = -1;   // the running job's CPU_DONE; older ones were preempted
+        long long clock = 0;
+
+        vector<long long> params = checkpointParams(ENGINE_BURSTS, costModel, numDevices, policy, timeQuantum);
+        params.push_back(bursts.fingerprint());
+        params.push_back(llround(model.alpha * 1e6));
+        params.push_back(llround(model.initialBurst * 1e6));
+        unsigned long long fingerprint = Snapshot::fingerprint(processes, params);
+        Snapshot snapshot;
+        long long nextCheckpoint = checkpoint.interval;
+
+        if (checkpoint.resume) {
+            vector<Process> input = processes;
+            vector<SimEvent> pendingEvents;
+            bool restored = snapshot.load(checkpoint.path) && snapshot.checkHeader(fingerprint) &&
+                            snapshot.getVector(processes) && snapshot.getVector(slot) &&
+                            snapshot.getVector(remaining) && snapshot.getVector(readySince) &&
+                            snapshot.getVector(ioSince) && snapshot.get(seq) &&
+                            snapshot.getVector(pendingEvents) && snapshot.getVector(ready) &&
+                            snapshot.getVector(deviceJob) && snapshot.get(stats.makespan) &&
+                            snapshot.get(stats.cpuBusy) && snapshot.getVector(stats.deviceBusy) &&
+                            snapshot.getVector(stats.deviceQueueWait) &&
+                            snapshot.getVector(stats.deviceRequests) && switches.load(snapshot) &&
+                            snapshot.get(running) && snapshot.get(runLength) && snapshot.get(runStart) &&
+                            snapshot.get(runSeq) && model.load(snapshot) && snapshot.get(clock);
+            for (int d = 0; d < numDevices && restored; d++) {
+                vector<int> queued;
+                restored = snapshot.getVector(queued);
+                deviceQueue[d].assign(queued.begin(), queued.end());
+            }
+            if (!restored) {
+                return burstSequences(input, bursts, numDevices, policy, timeQuantum, stats, costModel,
+                                      queueKind, restartFromScratch(checkpoint), predictor);
+            }
+            // any queue replays the same (time, seq) order from a sorted refill
+            sort(pendingEvents.begin(), pendingEvents.end(), greater<SimEvent>());
+            for (size_t k = pendingEvents.size(); k-- > 0; ) events.push(pendingEvents[k]);
+            nextCheckpoint = nextCheckpointAfter(clock, checkpoint);
+        } else {
+            for (int i = 0; i < n; i++) {
+                events.push(SimEvent(processes[i].arrivalTime, seq++, SimEvent::ARRIVAL, i));
+            }
+        }
+
+        phase.next("simulate");
+        while (!events.empty()) {
+            if (checkpoint.due(clock, nextCheckpoint)) {
+                vector<SimEvent> pendingEvents;
+                events.collect(pendingEvents);
+                snapshot.putHeader(fingerprint);
+                snapshot.putVector(processes);
+                snapshot.putVector(slot);
+                snapshot.putVector(remaining);
+                snapshot.putVector(readySince);
+                snapshot.putVector(ioSince);
+                snapshot.put(seq);
+                snapshot.putVector(pendingEvents);
+                snapshot.putVector(ready);
+                snapshot.putVector(deviceJob);
+                snapshot.put(stats.makespan);
+                snapshot.put(stats.cpuBusy);
+                snapshot.putVector(stats.deviceBusy);
+                snapshot.putVector(stats.deviceQueueWait);
+                snapshot.putVector(stats.deviceRequests);
+                switches.save(snapshot);
+                snapshot.put(running);
+                snapshot.put(runLength);
+                snapshot.put(runStart);
+                snapshot.put(runSeq);
+                model.save(snapshot);
+                snapshot.put(clock);
+                for (int d = 0; d < numDevices; d++) {
+                    snapshot.putVector(vector<int>(deviceQueue[d].begin(), deviceQueue[d].end()));
+                }
+                snapshot.save(checkpoint.path);
+            }
+
+            long long now = events.top().time;
+            if (running < 0) counters.idleTick(now - clock);
+            clock = now;
+
+            // drain every event at this instant before the CPU picks
+            while (!events.empty() && events.top().time == now) {
+                SimEvent event = events.top();
+                events.pop();
+
+                if (event.type == SimEvent::ARRIVAL) {
+                    counters.arrivalScan();
+                    makeReady(event.job, now);
+                } else if (event.type == SimEvent::CPU_DONE) {
+                    if (event.seq != runSeq) continue;
+                    int i = event.job;
+                    running = -1;
+                    runSeq = -1;
+                    remaining[i] -= runLength;
+                    processes[i].remainingTime -= runLength;
+                    stats.cpuBusy += runLength;
+                    switches.stop(i, now);
+                    if (remaining[i] == 0) {
+                        model.observe(i, bursts.lengths[slot[i]]);
+                        advance(i, now);
+                    } else {
+                        readySince[i] = now;
+                        pushReady(seq, i);
+                    }
+                } else {
+                    int device = event.job;
+                    int i = deviceJob[device];
+                    deviceJob[device] = -1;
+                    if (!deviceQueue[device].empty()) startIo(device, now);
+                    advance(i, now);
+                }
+            }
+
+            if (policy == POLICY_SRTF_PREDICTED && running >= 0 && !ready.empty()) {
+                int i = running;
+                long long ran = max(0LL, now - runStart);
+                long long key = predictedKey(i, ran);
+                if (ready.front().first.first < key) {
+                    running = -1;
+                    runSeq = -1;
+                    remaining[i] -= ran;
+                    processes[i].remainingTime -= ran;
+                    stats.cpuBusy += ran;
+                    switches.stop(i, now);
+                    readySince[i] = now;
+                    pushReady(key, i);
+                }
+            }
+
+            if (running < 0 && !ready.empty()) {
+                int i = ready.front().second;
+                counters.pop();
+                counters.slice();
+                pop_heap(ready.begin(), ready.end(), ReadyAfter());
+                ready.pop_back();
+                processes[i].waitingTime += (int)(now - readySince[i]);
+                runStart = now + switches.dispatch(processes[i], i, now);
+                runLength = remaining[i];
+                if (policy == POLICY_RR && timeQuantum > 0) {
+                    runLength = min<long long>(runLength, timeQuantum);
+                }
+                running = i;
+                runSeq = seq;
+                events.push(SimEvent(runStart + runLength, seq++, SimEvent::CPU_DONE, i));
+            }
+        }
+
+        return processes;
+    }
+    
+    // Gang scheduling on `cores` identical cores: a job starts only when
+    // `threads` cores are free, takes them all at once and runs to
+    // completion (gangs wider than the machine are narrowed to it). Queued
+    // gangs start in arrival order. With backfilling (EASY), the head of
+    // the queue reserves the earliest time enough cores free up, and later
+    // gangs within backfillDepth of it may jump ahead when they fit now and
+    // either finish before that reservation or use only cores it leaves
+    // spare, so the head is never delayed. Each start is a switch onto
+    // cold cores. Slices go to the active sink on one track per core.
+    static vector<Process> gang(vector<Process> processes, int cores, bool backfill, GangStats& stats,
+                                const SwitchCostModel& costModel = SwitchCostModel(),
+                                int backfillDepth = GANG_BACKFILL_DEPTH) {
+        struct Running {
+            long long end;
+            int job;
+        };
+
+        EngineCounters::Run run("gang");
+        EngineCounters& counters = EngineCounters::current();
+        SimulationContext& context = SimulationContext::current();
+        SimulationContext::Scope scratch;
+        EngineCounters::Phase phase("sort");
+        if (cores <= 0) cores = 1;
+        int n = processes.size();
+        const int* order = sortedByArrival(processes);
+        phase.next("simulate");
+
+        // waiting gangs: doubly linked list in arrival order, sentinel n
+        int* next = context.allocate<int>(n + 1);
+        int* prev = context.allocate<int>(n + 1);
+        next[n] = prev[n] = n;
+        Running* running = context.allocate<Running>(cores);   // by end time, latest first
+        int* freeCores = context.allocate<int>(cores);
+        int* owner = context.allocate<int>(cores, -1);
+        int runningCount = 0, freeCount = cores;
+        for (int c = 0; c < cores; c++) freeCores[c] = cores - 1 - c;
+
+        SliceSink* sink = SliceSink::active();
+        if (sink) sink->beginRun(backfill ? "Gang (backfill)" : "Gang");
+        int overhead = costModel.switchCost + costModel.cacheRefill(-1);
+        auto width = [&](int i) { return min(max(processes[i].threads, 1), cores); };
+
+        stats = GangStats();
+        stats.cores = cores;
+        long long now = 0;
+        int nextArrival = 0, finished = 0, waitingCount = 0;
+
+        auto start = [&](int i) {
+            next[prev[i]] = next[i];
+            prev[next[i]] = prev[i];
+            waitingCount--;
+            counters.slice();
+
+            Process& process = processes[i];
+            int need = width(i);
+            long long end = now + overhead + process.burstTime;
+            process.waitingTime = (int)(now - process.arrivalTime);
+            process.firstRunTime = (int)now;
+            process.contextSwitches++;
+            process.switchTime += costModel.switchCost;
+            process.cacheRefillTime += overhead - costModel.switchCost;
+            process.completionTime = (int)end;
+            process.turnaroundTime = process.completionTime - process.arrivalTime;
+            stats.busyCoreTime += (long long)need * (end - now);
+
+            for (int k = 0; k < need; k++) {
+                int core = freeCores[--freeCount];
+                owner[core] = i;
+                if (sink) {
+                    if (overhead > 0) sink->slice(GanttEntry(process.id, now, now + overhead, true, core));
+                    if (process.burstTime > 0) sink->slice(GanttEntry(process.id, now + overhead, end, false, core));
+                }
+            }
+            int pos = runningCount++;
+            while (pos > 0 && running[pos - 1].end < end) {
+                running[pos] = running[pos - 1];
+                pos--;
+            }
+            running[pos].end = end;
+            running[pos].job = i;
+        };
+
+        while (finished < n) {
+            long long event = LLONG_MAX;
+            if (runningCount > 0) event = running[runningCount - 1].end;
+            if (nextArrival < n) event = min(event, (long long)processes[order[nextArrival]].arrivalTime);
+            if (waitingCount > 0) stats.fragmentationIdle += (long long)freeCount * (event - now);
+            else counters.idleTick(event - now);
+            now = event;
+
+            while (runningCount > 0 && running[runningCount - 1].end <= now) {
+                int i = running[--runningCount].job;
+                for (int c = 0; c < cores; c++) {
+                    if (owner[c] == i) {
+                        owner[c] = -1;
+                        freeCores[freeCount++] = c;
+                    }
+                }
+                finished++;
+            }
+            while (nextArrival < n && processes[order[nextArrival]].arrivalTime <= now) {
+                int i = order[nextArrival++];
+                counters.push();
+                next[i] = n;
+                prev[i] = prev[n];
+                next[prev[n]] = i;
+                prev[n] = i;
+                waitingCount++;
+            }
+
+            while (next[n] != n && width(next[n]) <= freeCount) start(next[n]);
+            if (!backfill || next[n] == n || freeCount == 0) continue;
+
+            // the head's reservation: when, and how many cores to spare then
+            int head = next[n], available = freeCount;
+            long long shadow = now;
+            for (int k = runningCount - 1; k >= 0 && available < width(head); k--) {
+                available += width(running[k].job);
+                shadow = running[k].end;
+            }
+            int spare = available - width(head);
+
+            int scanned = 0;
+            for (int i = next[head]; i != n && scanned < backfillDepth && freeCount > 0; scanned++) {
+                int following = next[i];
+                counters.compare();
+                int need = width(i);
+                if (need <= freeCount) {
+                    if (now + overhead + processes[i].burstTime <= shadow) {
+                        start(i);
+                        stats.backfilled++;
+                    } else if (need <= spare) {
+                        spare -= need;
+                        start(i);
+                        stats.backfilled++;
+                    }
+                }
+                i = following;
+            }
+        }
+        stats.makespan = now;
+        return processes;
+    }
+    
+    // FCFS, SJF, Round Robin or Priority on a DVFS core. Times are ms and
+    // waitingTime excludes the (possibly stretched) execution time. With
+    // GOVERNOR_PERFORMANCE and a top speed of 1 the schedule is the plain
+    // engine's. O(levels) extra work per dispatch.
+    // Throws invalid_argument for Round Robin with a quantum below 1.
+    static vector<Process> energyAware(const vector<Process>& processes, CpuPolicy policy, int timeQuantum,
+                                       const DvfsModel& dvfs, DvfsGovernor governor, EnergyStats& stats,
+                                       const SwitchCostModel& costModel = SwitchCostModel()) {
+        if (policy == POLICY_RR && timeQuantum <= 0) {
+            throw invalid_argument(string("Round Robin time quantum ") + to_string(timeQuantum) +
+                                   " must be positive");
+        }
+        EngineCounters::Run run("energyAware");
+        vector<Process> result = processes;
+        if (policy == POLICY_FCFS) sortByArrival(result, 0);
+        stats = EnergyStats();
+        stats.levelTime.assign(dvfs.levels.size(), 0);
+        if (result.empty() || dvfs.levels.empty()) return result;
+        if (policy == POLICY_FCFS) {
+            runDvfs<FifoQueue>(result, RunToCompletion(), dvfs, governor, stats, costModel, "FCFS (DVFS)");
+        } else if (policy == POLICY_SJF) {
+            runDvfs<KeyedQueue<ShortestBurst>>(result, RunToCompletion(), dvfs, governor, stats, costModel,
+                                               "SJF (DVFS)");
+        } else if (policy == POLICY_RR) {
+            runDvfs<FifoQueue>(result, QuantumExpiry(timeQuantum), dvfs, governor, stats, costModel,
+                               "Round Robin (DVFS)");
+        } else {
+            runDvfs<KeyedQueue<HighestPriority>>(result, RunToCompletion(), dvfs, governor, stats, costModel,
+                                                 "Priority (DVFS)");
+        }
+        return result;
+    }
+    
+    static long long calculateTotalSwitchOverhead(const vector<Process>& processes) {
+        long long total = 0;
+        for (const auto& process : processes) {
+            total += process.switchOverhead();
+        }
+        return total;
+    }
+    
+    static long long calculateTotalContextSwitches(const vector<Process>& processes) {
+        long long total = 0;
+        for (const auto& process : processes) {
+            total += process.contextSwitches;
+        }
+        return total;
+    }
+    
+    static double calculateAverageWaitingTime(const vector<Process>& processes) {
+        double total = 0;
+        for (const auto& process : processes) {
+            total += process.waitingTime;
+        }
+        return total / processes.size();
+    }
+    
+    static double calculateAverageTurnaroundTime(const vector<Process>& processes) {
+        double total = 0;
+        for (const auto& process : processes) {
+            total += process.turnaroundTime;
+        }
+        return total / processes.size();
+    }
+
+private:
+    enum EngineTag { ENGINE_CFS = 1, ENGINE_EDF, ENGINE_RM, ENGINE_BURSTS };
+
+    static const size_t PARALLEL_FCFS_MIN_CHUNK = 65536;   // smaller chunks cost more than they save
+    static const int GANG_BACKFILL_DEPTH = 1000;   // queued gangs examined per backfill pass
+
+    // Stable, so jobs arriving together keep their submission order and
+    // fcfs() and parallelFcfs() agree on ties.
+    static void sortByArrival(vector<Process>& processes, int threads) {
+        SimulationContext::Scope scratch;
+        const int* order = sortedByArrival(processes, threads);
+        vector<Process> sorted(processes.size());
+        for (size_t k = 0; k < processes.size(); k++) sorted[k] = processes[order[k]];
+        processes.swap(sorted);
+    }
+
+    // SchedulingEngine's loop with a frequency chosen per slice.
+    template <typename ReadyQueue, typename Preemption>
+    static void runDvfs(vector<Process>& processes, const Preemption& preemption, const DvfsModel& dvfs,
+                        DvfsGovernor governor, EnergyStats& stats, const SwitchCostModel& costModel,
+                        const char* engine) {
+        SimulationContext::Scope scratch;
+        SimulationContext& context = SimulationContext::current();
+        int n = processes.size();
+        const int* order = sortedByArrival(processes);
+        ReadyQueue ready(n);
+        int* arrived = context.allocate<int>(n);
+        long long* runTime = context.allocate<long long>(n, 0);
+        SwitchTracker switches(costModel, n, engine);
+        for (auto& process : processes) process.remainingTime = process.burstTime;
+        const FrequencyLevel& top = dvfs.levels[0];
+
+        int nextArrival = 0, completed = 0, waiting = 0;
+        long long currentTime = 0;
+        auto release = [&]() {
+            int count = 0;
+            while (nextArrival < n && processes[order[nextArrival]].arrivalTime <= currentTime) {
+                arrived[count++] = order[nextArrival++];
+            }
+            sort(arrived, arrived + count);
+            for (int k = 0; k < count; k++) ready.push(arrived[k], processes[arrived[k]]);
+            waiting += count;
+        };
+        auto duration = [](int work, double speed) { return (long long)ceil(work / speed - 1e-9); };
+
+        release();
+        while (completed < n) {
+            if (ready.empty()) {
+                currentTime = processes[order[nextArrival]].arrivalTime;
+                release();
+                continue;
+            }
+
+            int idx = ready.pop();
+            waiting--;
+            Process& process = processes[idx];
+            int overhead = switches.dispatch(process, idx, currentTime);
+            currentTime += overhead;
+            stats.busyTime += overhead;
+            stats.busyJoules += top.watts * overhead / 1000.0;
+
+            int work = preemption.slice(process.remainingTime);
+            size_t level = 0;
+            long long fastest = duration(work, top.speed);
+            if (governor == GOVERNOR_ENERGY_AWARE) {
+                long long slack = waiting <= dvfs.stretchBacklog ? (long long)(fastest * (1 + dvfs.maxStretch))
+                                                                 : fastest;
+                if (waiting == 0) {
+                    slack = max(slack, nextArrival < n ? processes[order[nextArrival]].arrivalTime - currentTime
+                                                       : LLONG_MAX);
+                }
+                if (process.deadline > 0) {
+                    slack = min(slack, max(fastest, process.arrivalTime + process.deadline - currentTime));
+                }
+                // idle power fills the rest of the slack either way, so
+                // compare (watts - idle) x time
+                double best = (top.watts - dvfs.idleWatts) * fastest;
+                for (size_t l = 1; l < dvfs.levels.size(); l++) {
+                    long long time = duration(work, dvfs.levels[l].speed);
+                    double energy = (dvfs.levels[l].watts - dvfs.idleWatts) * time;
+                    if (time <= slack && energy < best) {
+                        best = energy;
+                        level = l;
+                    }
+                }
+            }
+            long long execTime = duration(work, dvfs.levels[level].speed);
+            currentTime += execTime;
+            process.remainingTime -= work;
+            runTime[idx] += execTime;
+            stats.busyTime += execTime;
+            stats.stretchTime += execTime - fastest;
+            stats.levelTime[level] += execTime;
+            stats.busyJoules += dvfs.levels[level].watts * execTime / 1000.0;
+            switches.stop(idx, currentTime);
+            release();
+
+            if (process.remainingTime == 0) {
+                process.completionTime = (int)currentTime;
+                process.turnaroundTime = process.completionTime - process.arrivalTime;
+                process.waitingTime = process.turnaroundTime - (int)runTime[idx] - process.switchOverhead();
+                completed++;
+            } else {
+                ready.push(idx, process);
+                waiting++;
+            }
+        }
+        stats.makespan = currentTime;
+        stats.idleJoules = dvfs.idleWatts * (stats.makespan - stats.busyTime) / 1000.0;
+    }
+
+    // Calls fn(chunk, begin, end) for `chunks` contiguous slices of [0, n),
+    // one thread per slice beyond the first, which runs on the caller.
+    template <typename Fn>
+    static void forEachChunk(size_t n, int chunks, Fn fn) {
+        vector<thread> workers;
+        for (int c = 1; c < chunks; c++) {
+            workers.push_back(thread(fn, c, n * c / chunks, n * (c + 1) / chunks));
+        }
+        fn(0, (size_t)0, n / chunks);
+        for (size_t t = 0; t < workers.size(); t++) workers[t].join();
+    }
+
+    // Engine, cost model and policy parameters folded into a snapshot's
+    // fingerprint, so a snapshot only resumes the run it was taken from.
+    static vector<long long> checkpointParams(EngineTag engine, const SwitchCostModel& costModel,
+                                              long long a = 0, long long b = 0, long long c = 0) {
+        long long params[] = {engine, costModel.switchCost, costModel.maxCacheRefill,
+                              costModel.cacheColdTime, a, b, c};
+        return vector<long long>(params, params + 7);
+    }
+
+    static CheckpointOptions restartFromScratch(const CheckpointOptions& checkpoint) {
+        cout << "Cannot resume from '" << checkpoint.path
+             << "' (missing, damaged, or from another workload); starting from the beginning.\n";
+        CheckpointOptions fresh = checkpoint;
+        fresh.resume = false;
+        return fresh;
+    }
+
+    static long long nextCheckpointAfter(long long now, const CheckpointOptions& checkpoint) {
+        return checkpoint.interval > 0 ? (now / checkpoint.interval + 1) * checkpoint.interval : 0;
+    }
+
+    // Shared EDF / RM simulation. Periodic instances are expanded lazily:
+    // each job keeps only its oldest pending instance and a backlog count
+    // (instances of one job share its priority and run in release order),
+    // so both heaps hold at most one entry per job regardless of how many
+    // instances the horizon covers. Results report, per job, the last
+    // completion, the worst-case response time as turnaround and the worst
+    // instance's ready-queue time, switch overhead excluded, as waiting.
+    static vector<Process> realTime(vector<Process> processes, int horizon, bool earliestDeadline,
+                                    DeadlineStats& stats, const SwitchCostModel& costModel,
+                                    const CheckpointOptions& checkpoint) {
+        typedef pair<long long, int> Entry;   // (time or key, index)
+        typedef CountedCompare<greater<Entry>> EntryAfter;
+        const long long NO_DEADLINE = LLONG_MAX / 4;
+
+        EngineCounters::Run run(earliestDeadline ? "edf" : "rateMonotonic");
+        EngineCounters& counters = EngineCounters::current();
+        SimulationContext::Scope scratch;   // SwitchTracker state
+        EngineCounters::Phase phase("setup");
+        int n = processes.size();
+        vector<long long> headRelease(n), nextRelease(n);
+        vector<long long> pending(n, 0), remaining(n, 0);
+        vector<long long> worstResponse(n, 0), worstWaiting(n, 0);
+        vector<long long> instanceOverhead(n, 0);   // switch cost charged to the head instance
+
+        auto relativeDeadline = [&](int i) -> long long {
+            if (processes[i].deadline > 0) return processes[i].deadline;
+            if (processes[i].period > 0) return processes[i].period;
+            return NO_DEADLINE;
+        };
+        auto readyKey = [&](int i) -> long long {
+            if (earliestDeadline) return headRelease[i] + relativeDeadline(i);
+            return processes[i].period > 0 ? processes[i].period : relativeDeadline(i);
+        };
+
+        // min-heaps kept in plain vectors so they can be snapshotted as-is
+        vector<Entry> releases, ready;
+        auto heapPush = [&](vector<Entry>& heap, const Entry& entry) {
+            counters.push();
+            heap.push_back(entry);
+            push_heap(heap.begin(), heap.end(), EntryAfter());
+        };
+        auto heapPop = [&](vector<Entry>& heap) {
+            counters.pop();
+            pop_heap(heap.begin(), heap.end(), EntryAfter());
+            heap.pop_back();
+        };
+
+        for (int i = 0; i < n; i++) {
+            nextRelease[i] = processes[i].arrivalTime;
+            heapPush(releases, Entry(nextRelease[i], i));
+        }
+
+        SwitchTracker switches(costModel, n, earliestDeadline ? "EDF" : "Rate Monotonic");
+        long long currentTime = 0;
+
+        unsigned long long fingerprint = Snapshot::fingerprint(processes,
+            checkpointParams(earliestDeadline ? ENGINE_EDF : ENGINE_RM, costModel, horizon));
+        Snapshot snapshot;
+        long long nextCheckpoint = checkpoint.interval;
+
+        if (checkpoint.resume) {
+            vector<Process> input = processes;
+            bool restored = snapshot.load(checkpoint.path) && snapshot.checkHeader(fingerprint) &&
+                            snapshot.getVector(processes) && snapshot.getVector(headRelease) &&
+                            snapshot.getVector(nextRelease) && snapshot.getVector(pending) &&
+                            snapshot.getVector(remaining) && snapshot.getVector(worstResponse) &&
+                            snapshot.getVector(worstWaiting) && snapshot.getVector(instanceOverhead) &&
+                            snapshot.getVector(releases) && snapshot.getVector(ready) &&
+                            snapshot.get(currentTime) && snapshot.get(stats) && switches.load(snapshot);
+            if (!restored) {
+                return realTime(input, horizon, earliestDeadline, stats, costModel,
+                                restartFromScratch(checkpoint));
+            }
+            nextCheckpoint = nextCheckpointAfter(currentTime, checkpoint);
+        }
+
+        phase.next("simulate");
+        while (!releases.empty() || !ready.empty()) {
+            if (checkpoint.due(currentTime, nextCheckpoint)) {
+                snapshot.putHeader(fingerprint);
+                snapshot.putVector(processes);
+                snapshot.putVector(headRelease);
+                snapshot.putVector(nextRelease);
+                snapshot.putVector(pending);
+                snapshot.putVector(remaining);
+                snapshot.putVector(worstResponse);
+                snapshot.putVector(worstWaiting);
+                snapshot.putVector(instanceOverhead);
+                snapshot.putVector(releases);
+                snapshot.putVector(ready);
+                snapshot.put(currentTime);
+                snapshot.put(stats);
+                switches.save(snapshot);
+                snapshot.save(checkpoint.path);
+            }
+
+            while (!releases.empty() && releases.front().first <= currentTime) {
+                int i = releases.front().second;
+                counters.arrivalScan();
+                heapPop(releases);
+                if (pending[i]++ == 0) {
+                    headRelease[i] = nextRelease[i];
+                    remaining[i] = processes[i].burstTime;
+                    heapPush(ready, Entry(readyKey(i), i));
+                }
+                if (processes[i].period > 0 && nextRelease[i] + processes[i].period < horizon) {
+                    nextRelease[i] += processes[i].period;
+                    heapPush(releases, Entry(nextRelease[i], i));
+                }
+            }
+
+            if (ready.empty()) {
+                counters.idleTick(releases.front().first - currentTime);
+                currentTime = releases.front().first;
+                continue;
+            }
+
+            // the top only changes at a release, so run until the next one
+            int currentIdx = ready.front().second;
+            int overhead = switches.dispatch(processes[currentIdx], currentIdx, currentTime);
+            if (overhead > 0) {
+                // a release during the switch may preempt before any work is done
+                instanceOverhead[currentIdx] += overhead;
+                currentTime += overhead;
+                switches.stop(currentIdx, currentTime);
+                continue;
+            }
+            long long runUntil = currentTime + remaining[currentIdx];
+            if (!releases.empty()) {
+                runUntil = min(runUntil, releases.front().first);
+            }
+            counters.slice();
+            remaining[currentIdx] -= runUntil - currentTime;
+            currentTime = runUntil;
+            switches.stop(currentIdx, currentTime);
+
+            if (remaining[currentIdx] == 0) {
+                heapPop(ready);
+                long long response = currentTime - headRelease[currentIdx];
+                worstResponse[currentIdx] = max(worstResponse[currentIdx], response);
+                worstWaiting[currentIdx] = max(worstWaiting[currentIdx], response - processes[currentIdx].burstTime -
+                                                                         instanceOverhead[currentIdx]);
+                instanceOverhead[currentIdx] = 0;
+                processes[currentIdx].completionTime = (int)currentTime;
+                if (relativeDeadline(currentIdx) != NO_DEADLINE) {
+                    stats.record(response - relativeDeadline(currentIdx));
+                }
+
+                if (--pending[currentIdx] > 0) {
+                    headRelease[currentIdx] += processes[currentIdx].period;
+                    remaining[currentIdx] = processes[currentIdx].burstTime;
+                    heapPush(ready, Entry(readyKey(currentIdx), currentIdx));
+                }
+            }
+        }
+
+        for (int i = 0; i < n; i++) {
+            processes[i].remainingTime = 0;
+            processes[i].turnaroundTime = (int)worstResponse[i];
+            processes[i].waitingTime = (int)worstWaiting[i];
+        }
+
+        return processes;
+    }
+};
+
+// Rebuilds a workload from a Linux scheduler trace: `trace-cmd report`
+// output or the raw ftrace text buffer, with sched_switch and sched_wakeup
+// (or sched_wakeup_new) enabled. Each task (pid) becomes one job whose CPU
+// bursts are its runs between blocking and whose I/O bursts are its sleeps;
+// a task switched out while still runnable was preempted, so its burst
+// carries on. Times are microseconds from the first event; load() throws
+// overflow_error for a trace longer than the 32-bit Process fields hold
+// (about 35 minutes) rather than replaying part of it. The file is read a
+// line at a time, so only per-task state and the bursts stay in memory.
+class FtraceImporter {
+public:
+    struct Result {
+        vector<Process> processes;        // id = pid, priority = nice, burstTime = total CPU
+        BurstTable bursts;                // one private I/O device per job (sleeps never queue)
+        vector<long long> observedWaiting;   // runnable-but-not-running time per job
+        long long events;
+        long long skippedLines;
+        int cpus;                         // CPUs whose context switches were kept
+
+        Result() : events(0), skippedLines(0), cpus(0) {}
+    };
+
+    // cpu >= 0 keeps only that CPU's context switches, for traces of
+    // workloads pinned to one CPU; wakeups are always applied.
+    static bool load(const string& path, int cpu, Result& result) {
+        ifstream in(path.c_str());
+        if (!in) return false;
+
+        result = Result();
+        vector<Task> tasks;
+        unordered_map<int, int> byPid;
+        vector<bool> cpuSeen;
+        long long origin = -1;
+        long long lastTime = 0;
+        string line;
+
+        auto taskFor = [&](int pid, long long now) -> Task& {
+            auto found = byPid.find(pid);
+            if (found != byPid.end()) return tasks[found->second];
+            byPid[pid] = tasks.size();
+            tasks.push_back(Task(pid, now));
+            return tasks.back();
+        };
+
+        while (getline(in, line)) {
+            size_t event = line.find(": sched_switch:");
+            bool isSwitch = event != string::npos;
+            if (!isSwitch) event = line.find(": sched_wakeup");
+            long long stamp;
+            int eventCpu;
+            if (event == string::npos || !parseHeader(line, event, stamp, eventCpu)) {
+                result.skippedLines++;
+                continue;
+            }
+            if (origin < 0) origin = stamp;
+            long long now = stamp - origin;
+            if (now > INT_MAX) {
+                throw overflow_error(string("Trace time ") + to_string(now) +
+                                     " us does not fit the 32-bit Process fields");
+            }
+            lastTime = now;
+            size_t payload = line.find(':', event + 2) + 1;
+
+            if (!isSwitch) {
+                int pid, prio;
+                if (!parseWakeup(line, payload, pid, prio)) {
+                    result.skippedLines++;
+                    continue;
+                }
+                if (pid == 0) continue;
+                Task& task = taskFor(pid, now);
+                task.prio = prio;
+                task.wake(now);
+                result.events++;
+                continue;
+            }
+
+            int prevPid, prevPrio, nextPid, nextPrio;
+            bool prevRunnable;
+            if (!parseSwitch(line, payload, prevPid, prevPrio, prevRunnable, nextPid, nextPrio)) {
+                result.skippedLines++;
+                continue;
+            }
+            if (cpu >= 0 && eventCpu != cpu) continue;
+            if (eventCpu >= (int)cpuSeen.size()) cpuSeen.resize(eventCpu + 1, false);
+            cpuSeen[eventCpu] = true;
+            result.events++;
+
+            if (prevPid != 0) {
+                bool seen = byPid.count(prevPid) > 0;
+                Task& prev = taskFor(prevPid, 0);
+                if (!seen) prev.state = RUNNING;   // running since the trace began
+                prev.prio = prevPrio;
+                prev.switchOut(now, prevRunnable);
+            }
+            if (nextPid != 0) {
+                Task& next = taskFor(nextPid, now);
+                next.prio = nextPrio;
+                next.switchIn(now);
+            }
+        }
+
+        result.cpus = count(cpuSeen.begin(), cpuSeen.end(), true);
+        for (auto& task : tasks) {
+            task.finish(lastTime);
+            if (task.bursts.empty()) continue;   // never ran
+            int total = 0;
+            for (size_t k = 0; k < task.bursts.size(); k++) {
+                if (k % 2 == 0) {
+                    result.bursts.addCpuBurst(task.bursts[k]);
+                    total += task.bursts[k];
+                } else {
+                    result.bursts.addIoBurst(task.bursts[k], result.processes.size());
+                }
+            }
+            result.bursts.endJob();
+            result.processes.push_back(Process(task.pid, (int)task.arrival, total, task.prio - 120));
+            result.observedWaiting.push_back(task.waited);
+        }
+        return true;
+    }
+
+private:
+    enum TaskState { READY, RUNNING, SLEEPING };
+
+    struct Task {
+        int pid;
+        int prio;
+        long long arrival;
+        TaskState state;
+        long long since;
+        long long cpu;        // current CPU burst so far
+        long long waited;
+        vector<int> bursts;   // CPU, I/O, CPU, ...
+
+        Task(int id, long long now)
+            : pid(id), prio(120), arrival(now), state(READY), since(now), cpu(0), waited(0) {}
+
+        void wake(long long now) {
+            if (state != SLEEPING) return;
+            bursts.push_back((int)max(1LL, now - since));
+            state = READY;
+            since = now;
+        }
+
+        void switchIn(long long now) {
+            if (state == SLEEPING) wake(now);   // its wakeup fell outside the trace
+            if (state == READY) waited += now - since;
+            state = RUNNING;
+            since = now;
+        }
+
+        void switchOut(long long now, bool runnable) {
+            if (state != RUNNING) return;
+            cpu += now - since;
+            since = now;
+            if (runnable) {
+                state = READY;
+            } else {
+                endCpuBurst();
+                state = SLEEPING;
+            }
+        }
+
+        void finish(long long now) {
+            if (state == RUNNING) cpu += now - since;
+            if (state == READY) waited += now - since;
+            if (cpu > 0) endCpuBurst();
+            if (bursts.size() % 2 == 0 && !bursts.empty()) bursts.pop_back();   // woke but never ran
+        }
+
+        void endCpuBurst() {
+            bursts.push_back((int)max(1LL, cpu));
+            cpu = 0;
+        }
+    };
+
+    // "comm-pid [cpu] flags 1234.567890: event:" -> microseconds and cpu
+    static bool parseHeader(const string& line, size_t event, long long& stamp, int& cpu) {
+        size_t start = line.rfind(' ', event);
+        if (start == string::npos) return false;
+        long long seconds = 0, micros = 0;
+        int digits = 0;
+        size_t i = start + 1;
+        for (; i < event && isdigit((unsigned char)line[i]); i++) seconds = seconds * 10 + (line[i] - '0');
+        if (i == start + 1 || i >= event || line[i] != '.') return false;
+        for (i++; i < event && isdigit((unsigned char)line[i]); i++) {
+            if (digits++ < 6) micros = micros * 10 + (line[i] - '0');
+        }
+        for (; digits < 6; digits++) micros *= 10;
+        stamp = seconds * 1000000 + micros;
+
+        size_t close = line.rfind(']', start);
+        size_t open = close == string::npos ? string::npos : line.rfind('[', close);
+        if (open == string::npos) return false;
+        cpu = atoi(line.c_str() + open + 1);
+        return true;
+    }
+
+    // value of "key=" within [from, to), e.g. prev_pid=42
+    static bool field(const string& line, const char* key, size_t from, size_t to, string& value) {
+        size_t at = line.find(key, from);
+        if (at == string::npos || at >= to) return false;
+        at += strlen(key);
+        size_t end = line.find(' ', at);
+        value = line.substr(at, min(end, to) - at);
+        return true;
+    }
+
+    // trace-cmd's compact "comm:pid [prio]" form
+    static bool parseTask(const string& line, size_t from, size_t to, int& pid, int& prio) {
+        size_t open = line.find(" [", from);
+        if (open == string::npos || open >= to) return false;
+        size_t colon = line.rfind(':', open);
+        if (colon == string::npos || colon < from) return false;
+        pid = atoi(line.c_str() + colon + 1);
+        prio = atoi(line.c_str() + open + 2);
+        return true;
+    }
+
+    static bool parseWakeup(const string& line, size_t payload, int& pid, int& prio) {
+        string value;
+        if (field(line, " pid=", payload - 1, line.size(), value)) {
+            pid = atoi(value.c_str());
+            prio = field(line, " prio=", payload - 1, line.size(), value) ? atoi(value.c_str()) : 120;
+            return true;
+        }
+        while (payload < line.size() && line[payload] == ' ') payload++;
+        return parseTask(line, payload, line.size(), pid, prio);
+    }
+
+    static bool parseSwitch(const string& line, size_t payload, int& prevPid, int& prevPrio,
+                            bool& prevRunnable, int& nextPid, int& nextPrio) {
+        size_t arrow = line.find(" ==> ", payload);
+        if (arrow == string::npos) return false;
+        string value;
+        if (field(line, "prev_pid=", payload, arrow, value)) {
+            prevPid = atoi(value.c_str());
+            prevPrio = field(line, "prev_prio=", payload, arrow, value) ? atoi(value.c_str()) : 120;
+            prevRunnable = field(line, "prev_state=", payload, arrow, value) && value[0] == 'R';
+            if (!field(line, "next_pid=", arrow, line.size(), value)) return false;
+            nextPid = atoi(value.c_str());
+            nextPrio = field(line, "next_prio=", arrow, line.size(), value) ? atoi(value.c_str()) : 120;
+            return true;
+        }
+        while (payload < line.size() && line[payload] == ' ') payload++;
+        if (!parseTask(line, payload, arrow, prevPid, prevPrio)) return false;
+        size_t state = line.find("] ", line.find(" [", payload));
+        prevRunnable = state != string::npos && state + 2 < arrow && line[state + 2] == 'R';
+        return parseTask(line, arrow + 5, line.size(), nextPid, nextPrio);
+    }
 };
 
-class CPUScheduler {
+// Random workload: Poisson arrivals, exponential bursts (at least 1) and
+// uniform priorities, drawn fresh for every Monte Carlo replication.
+struct WorkloadModel {
+    int jobs;
+    double meanInterarrival;
+    double meanBurst;
+    int priorityLevels;
+
+    WorkloadModel(int n = 50, double interarrival = 4.0, double burst = 5.0, int levels = 5)
+        : jobs(n), meanInterarrival(interarrival), meanBurst(burst), priorityLevels(levels) {}
+
+    vector<Process> generate(mt19937_64& rng) const {
+        vector<Process> processes;
+        generate(rng, processes);
+        return processes;
+    }
+
+    // Refills `processes` in place, reusing its capacity.
+    void generate(mt19937_64& rng, vector<Process>& processes) const {
+        exponential_distribution<double> gap(1.0 / meanInterarrival);
+        exponential_distribution<double> burst(1.0 / meanBurst);
+        uniform_int_distribution<int> priority(1, max(1, priorityLevels));
+        processes.clear();
+        processes.reserve(jobs);
+        double arrival = 0;
+        for (int i = 0; i < jobs; i++) {
+            processes.emplace_back(i + 1, (int)arrival, 1 + (int)burst(rng), priority(rng));
+            arrival += gap(rng);
+        }
+    }
+};
+
+// Running mean and variance (Welford).
+struct RunningStat {
+    long long count;
+    double mean;
+    double m2;
+
+    RunningStat() : count(0), mean(0), m2(0) {}
+
+    void add(double x) {
+        count++;
+        double delta = x - mean;
+        mean += delta / count;
+        m2 += delta * (x - mean);
+    }
+
+    // half-width of the 95% confidence interval of the mean
+    double halfWidth95() const {
+        if (count < 2) return numeric_limits<double>::infinity();
+        return 1.96 * sqrt(m2 / (count - 1) / count);
+    }
+};
+
+struct MonteCarloOptions {
+    int minReplications;
+    int maxReplications;
+    double relativePrecision;   // stop once every half-width <= this fraction of its mean
+    int threads;                // 0 = all cores
+    unsigned long long seed;
+    int timeQuantum;
+    SwitchCostModel costModel;
+
+    MonteCarloOptions()
+        : minReplications(30), maxReplications(10000), relativePrecision(0.02),
+          threads(0), seed(2025), timeQuantum(2) {}
+};
+
+// Replicates a workload model through every policy in parallel and reports
+// mean and 95% CI per metric. Replication r always draws from its own RNG
+// stream seeded by (seed, r); rounds have a fixed size, threads take turns
+// at a round's replications and the samples are added in replication
+// order, so results do not depend on the thread count.
+class MonteCarlo {
 public:
-    static vector<Process> fcfs(vector<Process> processes) {
-        sort(processes.begin(), processes.end(), 
-             [](const Process& a, const Process& b) {
-                 return a.arrivalTime < b.arrivalTime;
-             });
-        
-        int currentTime = 0;
-        
-        for (auto& process : processes) {
-            if (currentTime < process.arrivalTime) {
-                currentTime = process.arrivalTime;
+    enum Metric { AVG_WAITING, AVG_TURNAROUND, MAKESPAN, METRIC_COUNT };
+    enum Algorithm { FCFS, SJF, ROUND_ROBIN, PRIORITY, CFS, ALGORITHM_COUNT };
+
+    struct Result {
+        RunningStat stats[ALGORITHM_COUNT][METRIC_COUNT];
+        int replications;
+        bool converged;
+    };
+
+    static const char* algorithmName(int algorithm) {
+        static const char* names[] = {"FCFS", "SJF", "Round Robin", "Priority", "CFS"};
+        return names[algorithm];
+    }
+
+    static const char* metricName(int metric) {
+        static const char* names[] = {"Avg Waiting", "Avg Turnaround", "Makespan"};
+        return names[metric];
+    }
+
+    static Result run(const WorkloadModel& model, const MonteCarloOptions& options) {
+        int threads = options.threads > 0 ? options.threads : (int)thread::hardware_concurrency();
+        threads = max(1, threads);
+
+        Result result;
+        result.replications = 0;
+        result.converged = false;
+
+        // rounds of minReplications, then add the samples and test the intervals
+        int round = max(1, options.minReplications);
+        vector<Sample> samples;
+        while (result.replications < options.maxReplications && !result.converged) {
+            int roundSize = min(options.maxReplications - result.replications, round);
+            samples.resize(roundSize);
+            vector<thread> workers;
+            for (int t = 0; t < min(threads, roundSize); t++) {
+                workers.push_back(thread([&, t]() {
+                    for (int r = t; r < roundSize; r += threads) {
+                        replicate(model, options, result.replications + r, samples[r]);
+                    }
+                }));
             }
-            
-            process.waitingTime = currentTime - process.arrivalTime;
-            process.completionTime = currentTime + process.burstTime;
+            for (auto& worker : workers) worker.join();
+
+            for (int r = 0; r < roundSize; r++) {
+                for (int a = 0; a < ALGORITHM_COUNT; a++) {
+                    for (int m = 0; m < METRIC_COUNT; m++) result.stats[a][m].add(samples[r].value[a][m]);
+                }
+            }
+            result.replications += roundSize;
+            result.converged = result.replications >= options.minReplications && precise(result, options);
+        }
+
+        return result;
+    }
+
+private:
+    // one replication's metrics
+    struct Sample {
+        double value[ALGORITHM_COUNT][METRIC_COUNT];
+    };
+
+    static void replicate(const WorkloadModel& model, const MonteCarloOptions& options,
+                          long long replication, Sample& acc) {
+        seed_seq seeds{(unsigned)options.seed, (unsigned)(options.seed >> 32),
+                       (unsigned)replication, (unsigned)(replication >> 32)};
+        mt19937_64 rng(seeds);
+        // kept per worker thread, so replications reuse the same buffers
+        static thread_local vector<Process> processes, result;
+        model.generate(rng, processes);
+
+        const SwitchCostModel& cost = options.costModel;
+        CPUScheduler::fcfs(processes, result, cost);
+        record(acc, FCFS, result);
+        CPUScheduler::sjf(processes, result, cost);
+        record(acc, SJF, result);
+        CPUScheduler::roundRobin(processes, result, options.timeQuantum, cost);
+        record(acc, ROUND_ROBIN, result);
+        CPUScheduler::priority(processes, result, cost);
+        record(acc, PRIORITY, result);
+        record(acc, CFS, CPUScheduler::cfs(processes, 6, 1, cost));
+    }
+
+    static void record(Sample& acc, Algorithm algorithm, const vector<Process>& result) {
+        int makespan = 0;
+        for (const auto& process : result) makespan = max(makespan, process.completionTime);
+        acc.value[algorithm][AVG_WAITING] = CPUScheduler::calculateAverageWaitingTime(result);
+        acc.value[algorithm][AVG_TURNAROUND] = CPUScheduler::calculateAverageTurnaroundTime(result);
+        acc.value[algorithm][MAKESPAN] = makespan;
+    }
+
+    static bool precise(const Result& result, const MonteCarloOptions& options) {
+        for (int a = 0; a < ALGORITHM_COUNT; a++) {
+            for (int m = 0; m < METRIC_COUNT; m++) {
+                const RunningStat& stat = result.stats[a][m];
+                if (stat.halfWidth95() > options.relativePrecision * fabs(stat.mean)) return false;
+            }
+        }
+        return true;
+    }
+};
+
+enum DispatchRule { DISPATCH_ROUND_ROBIN, DISPATCH_LEAST_LOADED, DISPATCH_POWER_OF_TWO };
+
+struct ClusterOptions {
+    int nodes;
+    CpuPolicy policy;           // every node runs this policy on its own CPU
+    int timeQuantum;
+    DispatchRule dispatch;
+    bool migrate;               // rebalance queued jobs between nodes at each sync
+    int migrationCost;          // a migrated job is ready on its new node this much later
+    int syncInterval;           // time between load exchanges (the lookahead window)
+    int threads;                // 0 = all cores
+    unsigned long long seed;    // power-of-two choices
+    SwitchCostModel costModel;
+
+    ClusterOptions()
+        : nodes(16), policy(POLICY_FCFS), timeQuantum(2), dispatch(DISPATCH_LEAST_LOADED),
+          migrate(false), migrationCost(10), syncInterval(50), threads(0), seed(2025) {}
+};
+
+struct ClusterStats {
+    int nodes;
+    long long makespan;
+    long long windows;
+    long long migrations;
+    long long migrationDelay;    // total time migrated jobs spent in transit
+    vector<long long> nodeBusy;  // CPU time per node, switch overhead included
+    vector<int> nodeJobs;        // jobs completed per node
+
+    ClusterStats() : nodes(0), makespan(0), windows(0), migrations(0), migrationDelay(0) {}
+
+    double utilization() const {
+        long long busy = accumulate(nodeBusy.begin(), nodeBusy.end(), 0LL);
+        return makespan == 0 || nodes == 0 ? 0.0 : (double)busy / ((double)nodes * makespan);
+    }
+
+    // busiest node's CPU time over the mean; 1 is perfectly balanced
+    double imbalance() const {
+        if (nodeBusy.empty()) return 1.0;
+        long long busy = accumulate(nodeBusy.begin(), nodeBusy.end(), 0LL);
+        long long peak = *max_element(nodeBusy.begin(), nodeBusy.end());
+        return busy == 0 ? 1.0 : (double)peak * nodes / busy;
+    }
+};
+
+// Many single-CPU nodes behind a global dispatcher. Time advances in
+// windows of syncInterval: at each boundary the dispatcher reads every
+// node's load, optionally migrates queued jobs from the most to the least
+// loaded nodes, and routes the jobs arriving in the next window; then the
+// nodes simulate the window independently, split across worker threads.
+// All routing decisions are made serially from boundary state, so results
+// do not depend on the thread count. One node without migration gives the
+// same schedule as the CPUScheduler engine for its policy.
+class ClusterSimulator {
+public:
+    static const char* dispatchName(DispatchRule rule) {
+        static const char* names[] = {"Round Robin", "Least Loaded", "Power of Two"};
+        return names[rule];
+    }
+
+    // Throws invalid_argument for Round Robin nodes with a quantum below 1.
+    static vector<Process> run(vector<Process> processes, const ClusterOptions& options, ClusterStats& stats) {
+        if (options.policy == POLICY_RR && options.timeQuantum <= 0) {
+            throw invalid_argument(string("Round Robin time quantum ") + to_string(options.timeQuantum) +
+                                   " must be positive");
+        }
+        int n = processes.size();
+        int nodeCount = max(1, options.nodes);
+        long long window = max(1, options.syncInterval);
+        stats = ClusterStats();
+        stats.nodes = nodeCount;
+        stats.nodeBusy.assign(nodeCount, 0);
+        stats.nodeJobs.assign(nodeCount, 0);
+        if (n == 0) return processes;
+
+        SimulationContext::Scope scratch;
+        SimulationContext& context = SimulationContext::current();
+        const int* order = sortedByArrival(processes);
+        Shared shared;
+        shared.processes = &processes;
+        shared.remaining = context.allocate<int>(n);
+        shared.lastStop = context.allocate<long long>(n, -1);
+        shared.options = &options;
+        for (int i = 0; i < n; i++) {
+            processes[i].remainingTime = processes[i].burstTime;
+            shared.remaining[i] = processes[i].burstTime;
+        }
+
+        vector<Node> nodes(nodeCount, Node(&shared));
+        Dispatcher dispatcher(nodeCount, options);
+        long long* load = context.allocate<long long>(nodeCount);
+        int* byLoad = context.allocate<int>(nodeCount);
+
+        int threads = options.threads > 0 ? options.threads : (int)thread::hardware_concurrency();
+        threads = max(1, min(threads, nodeCount));
+        long long boundary = 0;
+        Workers workers(threads, [&](int t) {
+            int begin = (long long)nodeCount * t / threads, end = (long long)nodeCount * (t + 1) / threads;
+            for (int k = begin; k < end; k++) nodes[k].advance(boundary + window);
+        });
+
+        int nextArrival = 0;
+        boundary = processes[order[0]].arrivalTime / window * window;
+        for (;;) {
+            long long outstanding = 0;
+            int completed = 0;
+            for (int k = 0; k < nodeCount; k++) {
+                load[k] = nodes[k].load(boundary);
+                outstanding += load[k];
+                completed += nodes[k].completed;
+            }
+            if (completed == n) break;
+            if (outstanding == 0 && nextArrival < n) {
+                // nothing to simulate until the next arrival's window
+                boundary = max(boundary, processes[order[nextArrival]].arrivalTime / window * window);
+            } else if (options.migrate && nodeCount > 1) {
+                migrate(nodes, load, byLoad, boundary, options.migrationCost, shared, stats);
+            }
+
+            dispatcher.reset(load, boundary);
+            while (nextArrival < n && processes[order[nextArrival]].arrivalTime < boundary + window) {
+                int job = order[nextArrival++];
+                const Process& process = processes[job];
+                nodes[dispatcher.route(process.arrivalTime, process.burstTime)].arrive(job, process.arrivalTime);
+            }
+
+            workers.step();
+            stats.windows++;
+            boundary += window;
+        }
+
+        for (int k = 0; k < nodeCount; k++) {
+            stats.nodeBusy[k] = nodes[k].busy;
+            stats.nodeJobs[k] = nodes[k].completed;
+        }
+        for (const auto& process : processes) stats.makespan = max(stats.makespan, (long long)process.completionTime);
+        return processes;
+    }
+
+private:
+    struct Shared {
+        vector<Process>* processes;
+        int* remaining;
+        long long* lastStop;    // per job, so a job's cache state follows it (cold after migrating)
+        const ClusterOptions* options;
+    };
+
+    // One CPU running the policy over the jobs routed to it. Jobs reach the
+    // node through a (time, job) arrival heap and are released into the
+    // ready queue at each scheduling decision, as in SchedulingEngine.
+    class Node {
+    public:
+        long long busy;
+        int completed;
+
+        explicit Node(Shared* shared)
+            : busy(0), completed(0), shared(shared), now(0), running(-1), sliceEnd(0), lastJob(-1),
+              pendingWork(0) {}
+
+        void arrive(int job, long long at) {
+            arrivals.push_back(make_pair(at, job));
+            push_heap(arrivals.begin(), arrivals.end(), greater<Arrival>());
+            pendingWork += shared->remaining[job];
+        }
+
+        // Work routed here and not yet done, as of time `at`.
+        long long load(long long at) const {
+            long long work = pendingWork;
+            if (running >= 0) work += shared->remaining[running] + max(0LL, sliceEnd - at);
+            return work;
+        }
+
+        // Simulates every event before `until`.
+        void advance(long long until) {
+            for (;;) {
+                if (running >= 0) {
+                    if (sliceEnd >= until) return;
+                    now = sliceEnd;
+                    int job = running;
+                    running = -1;
+                    shared->lastStop[job] = now;
+                    release();
+                    if (shared->remaining[job] > 0) enqueue(job);
+                    else finish(job);
+                }
+                release();
+                if (readyEmpty()) {
+                    if (arrivals.empty() || arrivals.front().first >= until) return;
+                    now = max(now, arrivals.front().first);
+                    continue;
+                }
+                dispatch(dequeue());
+            }
+        }
+
+        // Gives up the newest job that has reached this node, if it has not
+        // run yet (moving a started job only spreads it across caches) and
+        // has at most maxWork to do: the ready queue's tail, or failing
+        // that the last arrival heap leaf.
+        bool steal(long long at, long long maxWork, int& job) {
+            if (!fifo.empty()) job = fifo.back();
+            else if (!keyed.empty()) job = keyed.back().second;
+            else if (!arrivals.empty() && arrivals.back().first <= at) job = arrivals.back().second;
+            else return false;
+            const Process& process = (*shared->processes)[job];
+            if (shared->remaining[job] != process.burstTime || process.burstTime > maxWork) return false;
+
+            if (!fifo.empty()) fifo.pop_back();
+            else if (!keyed.empty()) keyed.pop_back();
+            else arrivals.pop_back();
+            pendingWork -= shared->remaining[job];
+            return true;
+        }
+
+    private:
+        typedef pair<long long, int> Arrival;
+        typedef pair<long long, int> Keyed;
+
+        Shared* shared;
+        vector<Arrival> arrivals;   // min-heap on (time, job)
+        deque<int> fifo;            // FCFS and Round Robin
+        vector<Keyed> keyed;        // SJF and Priority: min-heap on (key, job)
+        vector<int> batch;
+        long long now;
+        int running;
+        long long sliceEnd;
+        int lastJob;
+        long long pendingWork;
+
+        bool readyEmpty() const { return fifo.empty() && keyed.empty(); }
+
+        void release() {
+            if (arrivals.empty() || arrivals.front().first > now) return;
+            batch.clear();
+            while (!arrivals.empty() && arrivals.front().first <= now) {
+                batch.push_back(arrivals.front().second);
+                pop_heap(arrivals.begin(), arrivals.end(), greater<Arrival>());
+                arrivals.pop_back();
+            }
+            // FCFS keeps arrival order; the others queue a batch in input order
+            if (shared->options->policy != POLICY_FCFS) sort(batch.begin(), batch.end());
+            for (int job : batch) enqueue(job);
+        }
+
+        void enqueue(int job) {
+            CpuPolicy policy = shared->options->policy;
+            if (policy == POLICY_FCFS || policy == POLICY_RR) {
+                fifo.push_back(job);
+                return;
+            }
+            const Process& process = (*shared->processes)[job];
+            keyed.push_back(make_pair(policy == POLICY_SJF ? ShortestBurst::of(process)
+                                                           : HighestPriority::of(process), job));
+            push_heap(keyed.begin(), keyed.end(), greater<Keyed>());
+        }
+
+        int dequeue() {
+            int job;
+            if (!fifo.empty()) {
+                job = fifo.front();
+                fifo.pop_front();
+            } else {
+                job = keyed.front().second;
+                pop_heap(keyed.begin(), keyed.end(), greater<Keyed>());
+                keyed.pop_back();
+            }
+            pendingWork -= shared->remaining[job];
+            return job;
+        }
+
+        void dispatch(int job) {
+            const ClusterOptions& options = *shared->options;
+            Process& process = (*shared->processes)[job];
+            int overhead = 0;
+            if (process.firstRunTime < 0) process.firstRunTime = (int)now;
+            if (job != lastJob) {
+                lastJob = job;
+                long long stopped = shared->lastStop[job];
+                int refill = options.costModel.cacheRefill(stopped < 0 ? -1 : now - stopped);
+                process.contextSwitches++;
+                process.switchTime += options.costModel.switchCost;
+                process.cacheRefillTime += refill;
+                overhead = options.costModel.switchCost + refill;
+            }
+            int& remaining = shared->remaining[job];
+            int slice = options.policy == POLICY_RR ? min(options.timeQuantum, remaining) : remaining;
+            remaining -= slice;
+            busy += overhead + slice;
+            running = job;
+            sliceEnd = now + overhead + slice;
+        }
+
+        void finish(int job) {
+            Process& process = (*shared->processes)[job];
+            process.remainingTime = 0;
+            process.completionTime = (int)now;
+            process.turnaroundTime = process.completionTime - process.arrivalTime;
+            process.waitingTime = process.turnaroundTime - process.burstTime - process.switchOverhead();
+            completed++;
+        }
+    };
+
+    // Routes arrivals from the loads reported at the window boundary. Each
+    // node's backlog is tracked as the time it would drain, so least-loaded
+    // is the earliest drain time, kept in a tournament tree: O(log nodes)
+    // per job.
+    class Dispatcher {
+    public:
+        Dispatcher(int nodes, const ClusterOptions& options)
+            : nodes(nodes), leaves(1), rule(options.dispatch), cursor(0), rng(options.seed) {
+            while (leaves < nodes) leaves *= 2;
+            drain.assign(nodes, 0);
+            tree.assign(2 * leaves, -1);
+        }
+
+        void reset(const long long* load, long long boundary) {
+            for (int k = 0; k < nodes; k++) drain[k] = boundary + load[k];
+            if (rule != DISPATCH_LEAST_LOADED) return;
+            for (int i = 0; i < leaves; i++) tree[leaves + i] = i < nodes ? i : -1;
+            for (int i = leaves - 1; i >= 1; i--) tree[i] = better(tree[2 * i], tree[2 * i + 1]);
+        }
+
+        int route(long long arrival, int burst) {
+            int k;
+            if (rule == DISPATCH_ROUND_ROBIN) {
+                k = cursor;
+                cursor = (cursor + 1) % nodes;
+            } else if (rule == DISPATCH_LEAST_LOADED) {
+                k = tree[1];
+            } else {
+                k = rng() % nodes;
+                int other = nodes > 1 ? (k + 1 + rng() % (nodes - 1)) % nodes : k;
+                if (max(drain[other], arrival) < max(drain[k], arrival)) k = other;
+            }
+            drain[k] = max(drain[k], arrival) + burst;
+            if (rule == DISPATCH_LEAST_LOADED) {
+                for (int i = (leaves + k) / 2; i >= 1; i /= 2) tree[i] = better(tree[2 * i], tree[2 * i + 1]);
+            }
+            return k;
+        }
+
+    private:
+        int nodes;
+        int leaves;
+        DispatchRule rule;
+        int cursor;
+        mt19937_64 rng;
+        vector<long long> drain;
+        vector<int> tree;   // index of the node that drains first in each subtree
+
+        int better(int a, int b) const {
+            if (a < 0) return b;
+            if (b < 0) return a;
+            return drain[b] < drain[a] ? b : a;
+        }
+    };
+
+    // Persistent worker threads that each advance their own slice of the
+    // nodes once per step(); step() returns when every slice is done.
+    class Workers {
+    public:
+        Workers(int count, const function<void(int)>& body)
+            : body(body), generation(0), running(0), stopping(false) {
+            for (int t = 1; t < count; t++) threads.push_back(thread([this, t]() { loop(t); }));
+        }
+
+        ~Workers() {
+            {
+                lock_guard<mutex> lock(mtx);
+                stopping = true;
+                generation++;
+            }
+            wake.notify_all();
+            for (auto& worker : threads) worker.join();
+        }
+
+        void step() {
+            {
+                lock_guard<mutex> lock(mtx);
+                running = threads.size();
+                generation++;
+            }
+            wake.notify_all();
+            body(0);
+            unique_lock<mutex> lock(mtx);
+            done.wait(lock, [this]() { return running == 0; });
+        }
+
+    private:
+        function<void(int)> body;
+        vector<thread> threads;
+        mutex mtx;
+        condition_variable wake, done;
+        long long generation;
+        int running;
+        bool stopping;
+
+        void loop(int t) {
+            long long seen = 0;
+            for (;;) {
+                {
+                    unique_lock<mutex> lock(mtx);
+                    wake.wait(lock, [&]() { return generation != seen; });
+                    seen = generation;
+                    if (stopping) return;
+                }
+                body(t);
+                lock_guard<mutex> lock(mtx);
+                if (--running == 0) done.notify_one();
+            }
+        }
+    };
+
+    // Pairs the k-th most loaded node with the k-th least loaded and moves
+    // queued jobs across while each move still narrows the gap by more
+    // than the transfer costs.
+    static void migrate(vector<Node>& nodes, long long* load, int* byLoad, long long boundary, int cost,
+                        Shared& shared, ClusterStats& stats) {
+        int count = nodes.size();
+        if (*max_element(load, load + count) - *min_element(load, load + count) <= cost) return;
+        iota(byLoad, byLoad + count, 0);
+        sort(byLoad, byLoad + count, [&](int a, int b) { return load[a] != load[b] ? load[a] < load[b] : a < b; });
+        for (int i = 0; i < count / 2; i++) {
+            int to = byLoad[i], from = byLoad[count - 1 - i];
+            int job;
+            while (load[from] - load[to] > cost && nodes[from].steal(boundary, (load[from] - load[to] - cost) / 2, job)) {
+                long long work = shared.remaining[job];
+                shared.lastStop[job] = -1;
+                nodes[to].arrive(job, boundary + cost);
+                load[from] -= work;
+                load[to] += work;
+                stats.migrations++;
+                stats.migrationDelay += cost;
+            }
+        }
+    }
+};
+
+// Runs the workload for real instead of simulating it: each job is a
+// CPU-bound spin of burstTime microseconds, released arrivalTime
+// microseconds after the start, executed by worker threads pinned one per
+// core. Workers take jobs from a shared ready queue ordered by policy. RR
+// jobs hand the worker back after each quantum (cooperative slicing); the
+// other policies run jobs to completion, like their simulated versions.
+// waitingTime (time spent in the ready queue) and turnaroundTime are
+// measured with steady_clock, in microseconds.
+class LiveExecutor {
+public:
+    static vector<Process> run(vector<Process> processes, CpuPolicy policy, int timeQuantum,
+                               int workers = 1) {
+        typedef chrono::steady_clock Clock;
+        typedef pair<pair<long long, long long>, int> ReadyEntry;   // ((key, seq), job)
+        const chrono::microseconds SPIN_WINDOW(200);
+
+        int n = processes.size();
+        int cores = max(1, (int)thread::hardware_concurrency());
+        workers = max(1, min(workers, cores));   // one pinned worker per core at most
+        SimulationContext::Scope scratch;
+        const int* order = sortedByArrival(processes);
+
+        mutex lock;
+        condition_variable changed;
+        vector<ReadyEntry> ready;   // min-heap
+        vector<long long> remaining(n);
+        vector<Clock::time_point> queuedAt(n), finishedAt(n);
+        vector<Clock::duration> waited(n, Clock::duration::zero());
+        int nextArrival = 0, completed = 0;
+        long long seq = 0;
+        for (int i = 0; i < n; i++) remaining[i] = max(0, processes[i].burstTime);
+
+        // a little slack so every worker is pinned and waiting at time zero
+        Clock::time_point start = Clock::now() + chrono::milliseconds(5);
+        auto releaseTime = [&](int i) {
+            return start + chrono::microseconds(processes[i].arrivalTime);
+        };
+        auto pushReady = [&](int i, Clock::time_point since) {
+            long long key = seq;
+            if (policy == POLICY_SJF) key = processes[i].burstTime;
+            else if (policy == POLICY_PRIORITY) key = processes[i].priority;
+            queuedAt[i] = since;
+            ready.push_back(ReadyEntry(make_pair(key, seq++), i));
+            push_heap(ready.begin(), ready.end(), greater<ReadyEntry>());
+        };
+        // jobs count as waiting from their nominal release, however late it is noticed
+        auto releaseArrivals = [&](Clock::time_point now) {
+            while (nextArrival < n && releaseTime(order[nextArrival]) <= now) {
+                int i = order[nextArrival++];
+                pushReady(i, releaseTime(i));
+            }
+        };
+
+        auto worker = [&](int core) {
+            pin(core);
+            unique_lock<mutex> guard(lock);
+            while (completed < n) {
+                releaseArrivals(Clock::now());
+                if (ready.empty()) {
+                    if (nextArrival < n) {
+                        // timed waits wake tens of microseconds late, so spin out the last stretch
+                        Clock::time_point at = releaseTime(order[nextArrival]);
+                        if (at - Clock::now() > SPIN_WINDOW) {
+                            changed.wait_until(guard, at - SPIN_WINDOW);
+                        } else {
+                            guard.unlock();
+                            while (Clock::now() < at) this_thread::yield();
+                            guard.lock();
+                        }
+                    } else {
+                        changed.wait(guard);   // the rest are running elsewhere
+                    }
+                    continue;
+                }
+
+                int i = ready.front().second;
+                pop_heap(ready.begin(), ready.end(), greater<ReadyEntry>());
+                ready.pop_back();
+                Clock::time_point sliceStart = Clock::now();
+                waited[i] += sliceStart - queuedAt[i];
+                if (processes[i].firstRunTime < 0) {
+                    processes[i].firstRunTime = (int)chrono::duration_cast<chrono::microseconds>(sliceStart - start).count();
+                }
+                long long slice = remaining[i];
+                if (policy == POLICY_RR && timeQuantum > 0) slice = min<long long>(slice, timeQuantum);
+
+                guard.unlock();
+                Clock::time_point sliceEnd = sliceStart + chrono::microseconds(slice);
+                while (Clock::now() < sliceEnd) {
+                    // the task itself: pure CPU until its slice is used up
+                }
+                Clock::time_point now = Clock::now();
+                guard.lock();
+
+                remaining[i] -= slice;
+                releaseArrivals(now);   // as in the simulator, arrivals queue ahead of the preempted job
+                if (remaining[i] > 0) {
+                    pushReady(i, now);
+                    changed.notify_one();
+                } else {
+                    finishedAt[i] = now;
+                    if (++completed == n) changed.notify_all();
+                }
+            }
+        };
+
+        vector<thread> threads;
+        for (int w = 0; w < workers; w++) threads.push_back(thread(worker, w));
+        for (auto& t : threads) t.join();
+
+        for (int i = 0; i < n; i++) {
+            Process& process = processes[i];
+            process.remainingTime = 0;
+            process.waitingTime = (int)chrono::duration_cast<chrono::microseconds>(waited[i]).count();
+            process.completionTime = (int)chrono::duration_cast<chrono::microseconds>(finishedAt[i] - start).count();
             process.turnaroundTime = process.completionTime - process.arrivalTime;
-            
-            currentTime = process.completionTime;
         }
-        
         return processes;
     }
+
+private:
+    static void pin(int core) {
+#if defined(__linux__)
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(core, &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+#elif defined(_WIN32)
+        SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << core);
+#else
+        (void)core;
+#endif
+    }
+};
+
+void printDeadlineStats(const DeadlineStats& stats) {
+    cout << "Instances: " << stats.instances << " | Deadline misses: " << stats.misses
+         << " (" << fixed << setprecision(2) << stats.missRatio() * 100 << "%)\n";
+    if (stats.misses == 0) return;
+    cout << "Average Lateness: " << fixed << setprecision(2) << stats.averageLateness()
+         << " ms | Max Lateness: " << stats.maxLateness << " ms\n";
+    cout << "Lateness Distribution:\n";
+    for (int k = 1; k < DeadlineStats::LATENESS_BUCKETS; k++) {
+        if (stats.latenessHistogram[k] == 0) continue;
+        long long low = 1LL << (k - 1);
+        string range = k + 1 == DeadlineStats::LATENESS_BUCKETS ? ">= " + to_string(low)
+                                                                : string("[") + to_string(low) + ", " + to_string(low * 2) + ")";
+        cout << "  " << setw(12) << range
+             << setw(12) << stats.latenessHistogram[k] << "\n";
+    }
+}
+
+void printUtilization(const UtilizationStats& stats) {
+    cout << "Makespan: " << stats.makespan << " ms | CPU Utilization: " << fixed << setprecision(2)
+         << stats.cpuUtilization() * 100 << "%\n";
+    for (size_t d = 0; d < stats.deviceBusy.size(); d++) {
+        double avgQueueWait = stats.deviceRequests[d] == 0 ? 0.0
+                            : (double)stats.deviceQueueWait[d] / stats.deviceRequests[d];
+        cout << "Device " << d << " Utilization: " << fixed << setprecision(2)
+             << stats.deviceUtilization((int)d) * 100 << "% | Requests: " << stats.deviceRequests[d]
+             << " | Avg Queue Wait: " << avgQueueWait << " ms\n";
+    }
+}
+
+// Accuracy of the burst predictor and what it cost against oracle SJF.
+void printPrediction(const BurstPredictor& predictor, double predictedWaiting, double oracleWaiting) {
+    cout << "Burst prediction (alpha " << fixed << setprecision(2) << predictor.alpha << ", " << predictor.taskCount()
+         << " tasks, " << predictor.observationCount() << " bursts): MAE " << predictor.meanAbsoluteError()
+         << " ms | RMSE " << predictor.rootMeanSquaredError() << " ms | Bias " << showpos << predictor.bias()
+         << noshowpos << " ms\n";
+    cout << "Avg waiting " << predictedWaiting << " ms vs oracle SJF " << oracleWaiting << " ms (penalty "
+         << showpos << predictedWaiting - oracleWaiting << noshowpos << " ms";
+    if (oracleWaiting > 0) cout << ", " << showpos << (predictedWaiting / oracleWaiting - 1) * 100 << noshowpos << "%";
+    cout << ")\n";
+}
+
+void printResults(const vector<Process>& processes, const string& algorithm, int cpus = 1) {
+    cout << "\n" << algorithm << " Scheduling Results:\n";
+    cout << string(80, '=') << "\n";
+    cout << setw(8) << "Process" << setw(10) << "Arrival" << setw(8) << "Burst" 
+         << setw(12) << "Completion" << setw(10) << "Waiting" << setw(12) << "Turnaround"
+         << setw(10) << "Response" << "\n";
+    cout << string(80, '-') << "\n";
+    
+    for (const auto& process : processes) {
+        cout << setw(8) << (string("P") + to_string(process.id))
+             << setw(10) << process.arrivalTime
+             << setw(8) << process.burstTime
+             << setw(12) << process.completionTime
+             << setw(10) << process.waitingTime
+             << setw(12) << process.turnaroundTime
+             << setw(10) << process.responseTime() << "\n";
+    }
+    
+    ScheduleMetrics metrics = ScheduleMetrics::of(processes, cpus);
+    cout << string(80, '-') << "\n";
+    cout << "Average Waiting Time: " << fixed << setprecision(2) 
+         << metrics.averageWaiting << " ms | Max: " << metrics.maxWaiting << " ms\n";
+    cout << "Average Turnaround Time: " << fixed << setprecision(2) 
+         << metrics.averageTurnaround << " ms\n";
+    cout << "Average Response Time: " << metrics.averageResponse << " ms\n";
+    cout << "Throughput: " << setprecision(4) << metrics.throughput << " jobs/ms over " << metrics.span
+         << " ms | per " << metrics.window << " ms window: " << metrics.peakWindowJobs << " peak, "
+         << metrics.lowWindowJobs << " low\n";
+    if (metrics.cpuUtilization >= 0) {
+        cout << "CPU Utilization: " << setprecision(2) << metrics.cpuUtilization * 100 << "% | ";
+    }
+    cout << "Avg Slowdown: " << setprecision(2) << metrics.averageSlowdown << " (max " << metrics.maxSlowdown << ") | Jain's Fairness: "
+         << setprecision(3) << metrics.fairness << "\n";
+    if (ResultsCsv::active()) ResultsCsv::active()->write(processes, algorithm, metrics);
+    
+    long long overhead = CPUScheduler::calculateTotalSwitchOverhead(processes);
+    if (overhead > 0) {
+        long long cacheRefill = 0;
+        for (const auto& process : processes) {
+            cacheRefill += process.cacheRefillTime;
+        }
+        cout << "Context Switches: " << CPUScheduler::calculateTotalContextSwitches(processes)
+             << " | Switch Overhead: " << overhead << " ms ("
+             << overhead - cacheRefill << " switch + " << cacheRefill << " cache refill)\n";
+    }
+    EngineCounters::current().dump(cout);
+}
+
+// Core utilization of a gang run and where its idle core time went.
+void printGangStats(const GangStats& stats) {
+    long long capacity = (long long)stats.cores * stats.makespan;
+    cout << "Cores: " << stats.cores << " | Makespan: " << stats.makespan << " ms | Core Utilization: "
+         << fixed << setprecision(2) << stats.utilization() * 100 << "%\n";
+    cout << "Idle Core Time: " << stats.idleCoreTime() << " core-ms, of which fragmentation: "
+         << stats.fragmentationIdle << " core-ms ("
+         << (capacity == 0 ? 0.0 : 100.0 * stats.fragmentationIdle / capacity) << "% of capacity)\n";
+    cout << "Backfilled Jobs: " << stats.backfilled << "\n";
+}
+
+void printClusterStats(const ClusterStats& stats) {
+    cout << "Nodes: " << stats.nodes << " | Makespan: " << stats.makespan << " ms | Utilization: " << fixed
+         << setprecision(2) << stats.utilization() * 100 << "% | Imbalance (max/mean busy): "
+         << stats.imbalance() << "\n";
+    cout << "Migrations: " << stats.migrations << " (" << stats.migrationDelay << " ms in transit) | Sync windows: "
+         << stats.windows << "\n";
+    for (int k = 0; k < stats.nodes && k < 16; k++) {
+        cout << "  Node " << setw(2) << k << ": " << setw(6) << stats.nodeJobs[k] << " jobs, "
+             << setw(8) << stats.nodeBusy[k] << " ms busy\n";
+    }
+    if (stats.nodes > 16) cout << "  ... " << stats.nodes - 16 << " more nodes\n";
+}
+
+void printEnergyStats(const EnergyStats& stats, const DvfsModel& dvfs) {
+    cout << "Energy: " << fixed << setprecision(3) << stats.joules() << " J (busy " << stats.busyJoules
+         << " J, idle " << stats.idleJoules << " J) | Avg Power: " << setprecision(2) << stats.averageWatts()
+         << " W | EDP: " << setprecision(3) << stats.energyDelayProduct() << " J*s\n";
+    cout << "Time stretched by lower frequencies: " << stats.stretchTime << " ms\n";
+    for (size_t l = 0; l < dvfs.levels.size(); l++) {
+        cout << "  " << setprecision(0) << dvfs.levels[l].speed * 100 << "% speed (" << setprecision(2)
+             << dvfs.levels[l].watts << " W): " << stats.levelTime[l] << " ms\n";
+    }
+}
+
+void printQuantumTrajectory(const vector<QuantumStep>& trajectory) {
+    if (trajectory.empty()) return;
+    int low = trajectory[0].quantum, high = low;
+    for (const auto& step : trajectory) {
+        low = min(low, step.quantum);
+        high = max(high, step.quantum);
+    }
+    cout << "Quantum trajectory: " << trajectory.size() << " changes, range " << low << " to " << high << "\n";
+    cout << setw(10) << "Time" << setw(10) << "Quantum" << setw(10) << "Queued" << "\n";
+    size_t shown = min<size_t>(trajectory.size(), 20);
+    for (size_t k = 0; k < shown; k++) {
+        cout << setw(10) << trajectory[k].time << setw(10) << trajectory[k].quantum << setw(10)
+             << trajectory[k].queued << "\n";
+    }
+    if (trajectory.size() > shown) cout << "  ... " << trajectory.size() - shown << " more\n";
+}
+
+// Measured (live) and simulated waiting/turnaround side by side, per job.
+void printLiveComparison(const vector<Process>& live, const vector<Process>& simulated,
+                         const string& algorithm) {
+    vector<const Process*> byId(live.size(), 0);
+    for (const auto& process : simulated) {
+        for (size_t i = 0; i < live.size(); i++) {
+            if (live[i].id == process.id && !byId[i]) {
+                byId[i] = &process;
+                break;
+            }
+        }
+    }
+    
+    cout << "\n" << algorithm << " - Live vs Simulated (microseconds):\n";
+    cout << string(70, '=') << "\n";
+    cout << setw(8) << "Process" << setw(8) << "Burst" << setw(13) << "Sim Waiting" << setw(14) << "Live Waiting"
+         << setw(13) << "Sim Turnar." << setw(14) << "Live Turnar." << "\n";
+    cout << string(70, '-') << "\n";
+    for (size_t i = 0; i < live.size(); i++) {
+        cout << setw(8) << (string("P") + to_string(live[i].id)) << setw(8) << live[i].burstTime
+             << setw(13) << (byId[i] ? byId[i]->waitingTime : 0) << setw(14) << live[i].waitingTime
+             << setw(13) << (byId[i] ? byId[i]->turnaroundTime : 0) << setw(14) << live[i].turnaroundTime << "\n";
+    }
+    cout << string(70, '-') << "\n";
+    cout << "Average Waiting Time: " << fixed << setprecision(2)
+         << CPUScheduler::calculateAverageWaitingTime(simulated) << " simulated, "
+         << CPUScheduler::calculateAverageWaitingTime(live) << " live\n";
+    cout << "Average Turnaround Time: " << fixed << setprecision(2)
+         << CPUScheduler::calculateAverageTurnaroundTime(simulated) << " simulated, "
+         << CPUScheduler::calculateAverageTurnaroundTime(live) << " live\n";
+}
+
+void printMonteCarlo(const MonteCarlo::Result& result) {
+    cout << "\nMonte Carlo Evaluation: " << result.replications << " replications ("
+         << (result.converged ? "converged" : "stopped at limit") << ")\n";
+    cout << string(78, '=') << "\n";
+    cout << setw(14) << "Algorithm";
+    for (int m = 0; m < MonteCarlo::METRIC_COUNT; m++) cout << setw(21) << MonteCarlo::metricName(m);
+    cout << "\n" << setw(14) << "" << setw(63) << "mean +/- 95% CI half-width" << "\n";
+    cout << string(78, '-') << "\n";
+    for (int a = 0; a < MonteCarlo::ALGORITHM_COUNT; a++) {
+        cout << setw(14) << MonteCarlo::algorithmName(a);
+        for (int m = 0; m < MonteCarlo::METRIC_COUNT; m++) {
+            const RunningStat& stat = result.stats[a][m];
+            stringstream cell;
+            cell << fixed << setprecision(2) << stat.mean << " +/- " << stat.halfWidth95();
+            cout << setw(21) << cell.str();
+        }
+        cout << "\n";
+    }
+}
+
+// Replays a scheduler trace through each policy on one simulated CPU and
+// sets the simulated ready-queue waiting against what the trace recorded.
+// The burst engine models one CPU, so a multi-CPU trace is refused unless
+// a CPU number picks one CPU's schedule.
+void replayTrace(const string& path, int cpu, int timeQuantum) {
+    FtraceImporter::Result trace;
+    try {
+        if (!FtraceImporter::load(path, cpu, trace)) {
+            cout << "Cannot read trace file '" << path << "'\n";
+            return;
+        }
+    } catch (const overflow_error& error) {
+        cout << error.what() << "; record a shorter trace.\n";
+        return;
+    }
+    int n = trace.processes.size();
+    cout << "\nTrace Replay: " << path << "\n";
+    cout << string(70, '=') << "\n";
+    cout << trace.events << " scheduler events, " << trace.skippedLines << " other lines, "
+         << n << " tasks, " << trace.cpus << " CPU(s)\n";
+    if (trace.cpus > 1) {
+        cout << "The simulator models one CPU; pass a CPU number to replay that CPU's schedule.\n";
+        return;
+    }
+    if (n == 0) return;
+
+    double observed = 0;
+    for (int i = 0; i < n; i++) observed += trace.observedWaiting[i];
+    observed /= n;
+
+    const char* policyNames[] = {"FCFS", "SJF", "Round Robin", "Priority", "SJF (predicted)",
+                                 "SRTF (predicted)"};
+    cout << "\n" << setw(20) << "Schedule" << setw(18) << "Avg Waiting (us)" << setw(18) << "vs Observed"
+         << setw(14) << "CPU Util" << "\n";
+    cout << string(70, '-') << "\n";
+    cout << setw(20) << "Observed (trace)" << setw(18) << fixed << setprecision(1) << observed
+         << setw(18) << "-" << setw(14) << "-" << "\n";
+    for (int policy = POLICY_FCFS; policy <= POLICY_SRTF_PREDICTED; policy++) {
+        UtilizationStats stats;
+        vector<Process> result = CPUScheduler::burstSequences(trace.processes, trace.bursts, n,
+                                                              (CpuPolicy)policy, timeQuantum, stats);
+        double simulated = CPUScheduler::calculateAverageWaitingTime(result);
+        stringstream delta;
+        delta << fixed << setprecision(1) << showpos << simulated - observed;
+        cout << setw(20) << policyNames[policy] << setw(18) << noshowpos << simulated
+             << setw(18) << delta.str() << setw(13) << stats.cpuUtilization() * 100 << "%\n";
+    }
+}
+
+// Hold-model benchmark of the future-event lists: with n events pending,
+// repeatedly pop the earliest and push a successor a few ticks later, the
+// dense-timestamp pattern of large traces. Flat ns/op as n grows = O(1).
+void benchmarkEventQueues() {
+    const char* names[] = {"Binary Heap", "Calendar Queue", "Timing Wheel"};
+    const int HOLD_OPS = 2000000;
+    const int MAX_GAP = 64;
     
-    static vector<Process> sjf(vector<Process> processes) {
-        vector<bool> isCompleted(processes.size(), false);
-        int currentTime = 0;
-        int completedCount = 0;
-        
-        while (completedCount < processes.size()) {
-            int shortestIdx = -1;
-            int shortestBurst = INT_MAX;
-            
-            for (int i = 0; i < processes.size(); i++) {
-                if (!isCompleted[i] && processes[i].arrivalTime <= currentTime &&
-                    processes[i].burstTime < shortestBurst) {
-                    shortestBurst = processes[i].burstTime;
-                    shortestIdx = i;
-                }
+    cout << "\nEvent Queue Benchmark (hold model, gaps 0-" << MAX_GAP - 1 << ")\n";
+    cout << string(70, '=') << "\n";
+    cout << setw(12) << "Pending";
+    for (int k = 0; k < 3; k++) cout << setw(19) << names[k];
+    cout << "\n" << setw(12) << "" << setw(57) << "ns per pop + push" << "\n";
+    cout << string(70, '-') << "\n";
+    
+    for (int pending = 1000; pending <= 1000000; pending *= 10) {
+        cout << setw(12) << pending;
+        long long checksum[3];
+        for (int k = 0; k < 3; k++) {
+            unique_ptr<EventQueue> queue = EventQueue::create((EventQueueKind)k);
+            mt19937 rng(42);
+            long long seq = 0;
+            for (int i = 0; i < pending; i++) {
+                queue->push(SimEvent(rng() % MAX_GAP, seq++, SimEvent::ARRIVAL, i));
             }
             
-            if (shortestIdx == -1) {
-                currentTime++;
-            } else {
-                Process& process = processes[shortestIdx];
-                process.waitingTime = currentTime - process.arrivalTime;
-                process.completionTime = currentTime + process.burstTime;
-                process.turnaroundTime = process.completionTime - process.arrivalTime;
-                
-                currentTime = process.completionTime;
-                isCompleted[shortestIdx] = true;
-                completedCount++;
+            checksum[k] = 0;
+            auto start = chrono::steady_clock::now();
+            for (int op = 0; op < HOLD_OPS; op++) {
+                SimEvent event = queue->top();
+                queue->pop();
+                checksum[k] = checksum[k] * 31 + event.seq;
+                queue->push(SimEvent(event.time + rng() % MAX_GAP, seq++, event.type, event.job));
             }
+            double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+            cout << setw(19) << fixed << setprecision(1) << ns / HOLD_OPS;
         }
-        
-        return processes;
+        cout << (checksum[0] == checksum[1] && checksum[0] == checksum[2] ? "" : "  (order mismatch!)") << "\n";
+    }
+}
+
+// Strong scaling of parallelFcfs() on an arrival-sorted trace (speedup is
+// against its own one-thread run), checked against the serial fcfs().
+void benchmarkParallelFcfs(size_t n) {
+    vector<Process> processes;
+    processes.reserve(n);
+    mt19937 rng(42);
+    int arrival = 0;
+    for (size_t i = 0; i < n; i++) {
+        arrival += rng() % 12;   // mean gap just above the mean burst: busy with idle gaps
+        processes.push_back(Process((int)i + 1, arrival, 1 + rng() % 10));
     }
     
-    static vector<Process> roundRobin(vector<Process> processes, int timeQuantum) {
-        queue<int> readyQueue;
-        vector<bool> inQueue(processes.size(), false);
+    auto start = chrono::steady_clock::now();
+    vector<Process> serial = CPUScheduler::fcfs(processes);
+    double serialMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    
+    cout << "\nParallel FCFS Benchmark (" << n << " jobs, "
+         << thread::hardware_concurrency() << " hardware threads)\n";
+    cout << string(50, '=') << "\n";
+    cout << setw(10) << "Threads" << setw(14) << "Time (ms)" << setw(12) << "Speedup" << setw(14) << "Matches\n";
+    cout << string(50, '-') << "\n";
+    cout << setw(10) << "serial" << setw(14) << fixed << setprecision(1) << serialMs
+         << setw(12) << "-" << setw(13) << "-" << "\n";
+    
+    double oneThreadMs = 0;
+    for (int threads = 1; threads <= 32; threads *= 2) {
+        start = chrono::steady_clock::now();
+        vector<Process> parallel = CPUScheduler::parallelFcfs(processes, threads);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
         
-        for (auto& process : processes) {
-            process.remainingTime = process.burstTime;
+        bool same = true;
+        for (size_t i = 0; i < n && same; i++) {
+            same = parallel[i].id == serial[i].id &&
+                   parallel[i].waitingTime == serial[i].waitingTime &&
+                   parallel[i].completionTime == serial[i].completionTime &&
+                   parallel[i].turnaroundTime == serial[i].turnaroundTime;
         }
+        if (threads == 1) oneThreadMs = ms;
+        cout << setw(10) << threads << setw(14) << setprecision(1) << ms
+             << setw(12) << setprecision(2) << oneThreadMs / ms << setw(13) << (same ? "yes" : "NO") << "\n";
+    }
+    EngineCounters::current().dump(cout);
+}
+
+// Arrival order for a large unsorted trace: stable_sort on indices, as
+// the engines used to, against the radix sort on 1 to 32 threads.
+void benchmarkArrivalSort(int n) {
+    vector<Process> processes;
+    processes.reserve(n);
+    mt19937 rng(42);
+    for (int i = 0; i < n; i++) {
+        processes.push_back(Process(i + 1, rng() % (n * 6 + 1), 1 + rng() % 10));
+    }
+    
+    auto start = chrono::steady_clock::now();
+    vector<int> expected(n);
+    iota(expected.begin(), expected.end(), 0);
+    stable_sort(expected.begin(), expected.end(),
+                [&](int a, int b) {
+                    return processes[a].arrivalTime < processes[b].arrivalTime;
+                });
+    double comparisonMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    
+    cout << "\nArrival Sort Benchmark (" << n << " jobs, "
+         << thread::hardware_concurrency() << " hardware threads)\n";
+    cout << string(62, '=') << "\n";
+    cout << setw(22) << "Sort" << setw(14) << "Time (ms)" << setw(12) << "Speedup" << setw(14) << "Matches\n";
+    cout << string(62, '-') << "\n";
+    cout << setw(22) << "stable_sort" << setw(14) << fixed << setprecision(1) << comparisonMs
+         << setw(12) << "-" << setw(13) << "-" << "\n";
+    
+    for (int threads = 1; threads <= 32; threads *= 2) {
+        SimulationContext::Scope scratch;
+        start = chrono::steady_clock::now();
+        const int* order = sortedByArrival(processes, threads);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
         
-        int currentTime = 0;
-        int completedCount = 0;
-        
-        for (int i = 0; i < processes.size(); i++) {
-            if (processes[i].arrivalTime <= currentTime) {
-                readyQueue.push(i);
-                inQueue[i] = true;
-            }
+        bool same = equal(expected.begin(), expected.end(), order);
+        ostringstream name;
+        name << "radix, " << threads << (threads == 1 ? " thread" : " threads");
+        cout << setw(22) << name.str() << setw(14) << setprecision(1) << ms
+             << setw(12) << setprecision(2) << comparisonMs / ms << setw(13) << (same ? "yes" : "NO") << "\n";
+    }
+}
+
+// Gang scheduling at scale: power-of-two gang widths up to the machine,
+// offered load just under the core count, strict FCFS against backfilling.
+void benchmarkGang(int gangs, int cores) {
+    if (gangs <= 0) gangs = 1;
+    if (cores <= 0) cores = 1;
+    int widths = 1;
+    while ((1 << widths) <= cores) widths++;
+    double meanWork = (double)((1 << widths) - 1) / widths * 50.5;   // width x burst
+    int maxGap = max(1, (int)(2 * meanWork / (0.95 * cores)));
+    
+    vector<Process> processes;
+    processes.reserve(gangs);
+    mt19937 rng(42);
+    int arrival = 0;
+    for (int i = 0; i < gangs; i++) {
+        arrival += rng() % (maxGap + 1);
+        processes.push_back(Process(i + 1, arrival, 1 + rng() % 100));
+        processes.back().threads = 1 << (rng() % widths);
+    }
+    
+    cout << "\nGang Scheduling Benchmark (" << gangs << " gangs, " << cores << " cores)\n";
+    cout << string(84, '=') << "\n";
+    cout << setw(12) << "Mode" << setw(12) << "Time (ms)" << setw(14) << "Avg Waiting" << setw(12) << "Makespan"
+         << setw(13) << "Utilization" << setw(12) << "Frag. Idle" << setw(10) << "Backfill\n";
+    cout << string(84, '-') << "\n";
+    for (int backfill = 0; backfill <= 1; backfill++) {
+        GangStats stats;
+        auto start = chrono::steady_clock::now();
+        vector<Process> result = CPUScheduler::gang(processes, cores, backfill != 0, stats);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        long long capacity = (long long)stats.cores * stats.makespan;
+        cout << setw(12) << (backfill ? "EASY" : "FCFS") << setw(12) << fixed << setprecision(1) << ms
+             << setw(14) << setprecision(2) << CPUScheduler::calculateAverageWaitingTime(result)
+             << setw(12) << stats.makespan << setw(12) << stats.utilization() * 100 << "%"
+             << setw(11) << 100.0 * stats.fragmentationIdle / capacity << "%" << setw(9) << stats.backfilled << "\n";
+    }
+    EngineCounters::current().dump(cout);
+}
+
+// A cluster at 90% offered load through every dispatch rule, with and
+// without migration, then the last configuration again on one thread to
+// check that the schedule does not depend on the thread count.
+void benchmarkCluster(int nodes, int jobs, int threads) {
+    if (nodes <= 0) nodes = 1;
+    if (jobs <= 0) jobs = 1;
+    double meanBurst = 50;
+    WorkloadModel model(jobs, meanBurst / (0.9 * nodes), meanBurst);
+    mt19937_64 rng(42);
+    vector<Process> processes = model.generate(rng);
+
+    ClusterOptions options;
+    options.nodes = nodes;
+    options.threads = threads;
+    int used = threads > 0 ? threads : max(1, (int)thread::hardware_concurrency());
+    cout << "\nCluster Benchmark (" << nodes << " nodes, " << jobs << " jobs, FCFS per node, "
+         << min(used, nodes) << " threads)\n";
+    cout << string(92, '=') << "\n";
+    cout << setw(14) << "Dispatch" << setw(9) << "Migrate" << setw(11) << "Time (ms)" << setw(14) << "Avg Waiting"
+         << setw(12) << "Makespan" << setw(13) << "Utilization" << setw(11) << "Imbalance" << setw(12) << "Migrations\n";
+    cout << string(92, '-') << "\n";
+    vector<Process> last;
+    for (int rule = DISPATCH_ROUND_ROBIN; rule <= DISPATCH_POWER_OF_TWO; rule++) {
+        for (int migrate = 0; migrate <= 1; migrate++) {
+            options.dispatch = (DispatchRule)rule;
+            options.migrate = migrate != 0;
+            ClusterStats stats;
+            auto start = chrono::steady_clock::now();
+            last = ClusterSimulator::run(processes, options, stats);
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            cout << setw(14) << ClusterSimulator::dispatchName(options.dispatch) << setw(9) << (migrate ? "yes" : "no")
+                 << setw(11) << fixed << setprecision(1) << ms
+                 << setw(14) << setprecision(2) << CPUScheduler::calculateAverageWaitingTime(last)
+                 << setw(12) << stats.makespan << setw(12) << stats.utilization() * 100 << "%"
+                 << setw(11) << stats.imbalance() << setw(11) << stats.migrations << "\n";
         }
-        
-        while (completedCount < processes.size()) {
-            if (readyQueue.empty()) {
-                currentTime++;
-                for (int i = 0; i < processes.size(); i++) {
-                    if (!inQueue[i] && processes[i].arrivalTime <= currentTime) {
-                        readyQueue.push(i);
-                        inQueue[i] = true;
-                    }
-                }
-                continue;
+    }
+
+    options.threads = 1;
+    ClusterStats stats;
+    auto start = chrono::steady_clock::now();
+    vector<Process> serial = ClusterSimulator::run(processes, options, stats);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    bool same = true;
+    for (int i = 0; i < jobs && same; i++) same = serial[i].completionTime == last[i].completionTime;
+    cout << "Single-threaded rerun: " << fixed << setprecision(1) << ms << " ms, identical schedule: "
+         << (same ? "yes" : "NO") << "\n";
+}
+
+// Sweeps offered load and stretch budget through both governors, as a
+// parameter study would, and reports the energy/waiting tradeoff and the
+// cost per simulated job.
+void benchmarkEnergy(int jobs) {
+    if (jobs <= 0) jobs = 1;
+    const double loads[] = {0.3, 0.6, 0.9};
+    const double stretches[] = {0, 0.5, 1.0};
+    const CpuPolicy policies[] = {POLICY_FCFS, POLICY_SJF};
+    const char* names[] = {"FCFS", "SJF"};
+    vector<Process> result;
+
+    cout << "\nEnergy Sweep (" << jobs << " jobs per run, 4 levels, P = 1 + 9 s^3 W, idle 0.5 W)\n";
+    cout << string(96, '=') << "\n";
+    cout << setw(6) << "Policy" << setw(6) << "Load" << setw(9) << "Stretch" << setw(13) << "Perf. (J)"
+         << setw(13) << "Aware (J)" << setw(9) << "Saved" << setw(11) << "EDP ratio" << setw(13) << "Wait Perf."
+         << setw(13) << "Wait Aware" << setw(13) << "ns/job\n";
+    cout << string(96, '-') << "\n";
+    double totalMs = 0;
+    long long simulated = 0;
+    for (int p = 0; p < 2; p++) {
+        for (double load : loads) {
+            WorkloadModel model(jobs, 10.0 / load, 10.0);
+            mt19937_64 rng(42);
+            vector<Process> processes = model.generate(rng);
+            EnergyStats perf;
+            result = CPUScheduler::energyAware(processes, policies[p], 2, DvfsModel(), GOVERNOR_PERFORMANCE, perf);
+            double perfWait = CPUScheduler::calculateAverageWaitingTime(result);
+            for (double stretch : stretches) {
+                DvfsModel dvfs;
+                dvfs.maxStretch = stretch;
+                EnergyStats aware;
+                auto start = chrono::steady_clock::now();
+                result = CPUScheduler::energyAware(processes, policies[p], 2, dvfs, GOVERNOR_ENERGY_AWARE, aware);
+                double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+                totalMs += ms;
+                simulated += jobs;
+                cout << setw(6) << names[p] << setw(6) << fixed << setprecision(1) << load << setw(9) << stretch
+                     << setw(13) << setprecision(1) << perf.joules() << setw(13) << aware.joules()
+                     << setw(8) << 100 * (1 - aware.joules() / perf.joules()) << "%"
+                     << setw(11) << setprecision(3) << aware.energyDelayProduct() / perf.energyDelayProduct()
+                     << setw(13) << setprecision(2) << perfWait
+                     << setw(13) << CPUScheduler::calculateAverageWaitingTime(result)
+                     << setw(12) << setprecision(1) << ms * 1e6 / jobs << "\n";
             }
-            
-            int currentIdx = readyQueue.front();
-            readyQueue.pop();
-            Process& currentProcess = processes[currentIdx];
-            
-            int execTime = min(timeQuantum, currentProcess.remainingTime);
-            currentTime += execTime;
-            currentProcess.remainingTime -= execTime;
-            
-            for (int i = 0; i < processes.size(); i++) {
-                if (!inQueue[i] && processes[i].arrivalTime <= currentTime && 
-                    processes[i].remainingTime > 0) {
-                    readyQueue.push(i);
-                    inQueue[i] = true;
+        }
+    }
+    cout << "Energy-aware runs: " << fixed << setprecision(1) << totalMs * 1e6 / simulated << " ns per job\n";
+}
+
+// Feeds a workload to an online engine the way a caller owning the clock
+// would: jobs are submitted as they arrive and next() is called whenever
+// the CPU frees up. Results land in `processes`; returns the engine calls.
+template <typename Engine>
+long long replayOnline(Engine& engine, vector<Process>& processes, bool arrivalOrder) {
+    SimulationContext::Scope scratch;
+    SimulationContext& context = SimulationContext::current();
+    int n = processes.size();
+    const int* order = sortedByArrival(processes);
+    int* batch = context.allocate<int>(n);
+    int* inputIndex = context.allocate<int>(n);   // by handle
+    long long now = 0, calls = 0;
+    int nextArrival = 0, completed = 0, running = -1;
+    bool finishing = false;
+    while (completed < n) {
+        int count = 0;
+        while (nextArrival < n && processes[order[nextArrival]].arrivalTime <= now) {
+            batch[count++] = order[nextArrival++];
+        }
+        if (!arrivalOrder) sort(batch, batch + count);
+        for (int k = 0; k < count; k++) inputIndex[engine.submit(processes[batch[k]])] = batch[k];
+        calls += count;
+
+        if (running >= 0 && finishing) {
+            processes[inputIndex[running]] = engine.complete(running, now);
+            completed++;
+            calls++;
+        }
+        typename Engine::Dispatch dispatch = engine.next(now);
+        calls++;
+        running = dispatch.job;
+        if (running < 0) {
+            if (nextArrival < n) now = processes[order[nextArrival]].arrivalTime;
+            continue;
+        }
+        finishing = dispatch.slice >= engine.job(running).remainingTime;
+        now += dispatch.overhead + dispatch.slice;
+    }
+    return calls;
+}
+
+// One row of benchmarkOnline: replay time per engine call, streaming
+// metrics, and whether the schedule matches the batch engine's.
+template <typename Engine>
+void reportOnline(const char* name, Engine& engine, const vector<Process>& processes, bool arrivalOrder,
+                  const vector<Process>& batch) {
+    vector<Process> online = processes;
+    auto start = chrono::steady_clock::now();
+    long long calls = replayOnline(engine, online, arrivalOrder);
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+
+    vector<int> completion(processes.size() + 1);
+    for (const auto& process : batch) completion[process.id] = process.completionTime;
+    bool same = true;
+    for (const auto& process : online) same = same && completion[process.id] == process.completionTime;
+    const OnlineMetrics& metrics = engine.metrics();
+    cout << setw(12) << name << setw(12) << calls << setw(10) << fixed << setprecision(1) << ns / calls
+         << setw(14) << setprecision(2) << metrics.averageWaiting() << setw(11) << metrics.maxWaiting
+         << setw(13) << metrics.utilization() * 100 << "%" << setw(9) << (same ? "yes" : "NO") << "\n";
+}
+
+// Replays one workload through each online engine against the batch result.
+void benchmarkOnline(int jobs) {
+    if (jobs <= 0) jobs = 1;
+    WorkloadModel model(jobs, 12.0, 4.5);
+    mt19937_64 rng(42);
+    vector<Process> processes = model.generate(rng);
+    SwitchCostModel cost(1, 2, 20);
+
+    cout << "\nOnline Engine Benchmark (" << jobs << " jobs, switch cost 1 + refill up to 2, q = 4)\n";
+    cout << string(80, '=') << "\n";
+    cout << setw(12) << "Policy" << setw(12) << "Calls" << setw(10) << "ns/call" << setw(14) << "Avg Waiting"
+         << setw(11) << "Max Wait" << setw(14) << "Utilization" << setw(10) << "Matches\n";
+    cout << string(80, '-') << "\n";
+    {
+        OnlineFcfs engine(jobs, RunToCompletion(), cost);
+        reportOnline("FCFS", engine, processes, true, CPUScheduler::fcfs(processes, cost));
+    }
+    {
+        OnlineSjf engine(jobs, RunToCompletion(), cost);
+        reportOnline("SJF", engine, processes, false, CPUScheduler::sjf(processes, cost));
+    }
+    {
+        OnlineRoundRobin engine(jobs, QuantumExpiry(4), cost);
+        reportOnline("Round Robin", engine, processes, false, CPUScheduler::roundRobin(processes, 4, cost));
+    }
+    {
+        OnlinePriority engine(jobs, RunToCompletion(), cost);
+        reportOnline("Priority", engine, processes, false, CPUScheduler::priority(processes, cost));
+    }
+}
+
+// Jobs per second from `producers` threads through a submission queue into
+// an OnlineFcfs engine on the calling thread, which drains batches and runs
+// each job to completion in simulated time. Locked = a mutex around a
+// std::deque, the baseline the ring replaces. `work` gets the sum of the
+// bursts the engine ran, to check both variants did the same work.
+template <bool Locked>
+double submissionThroughput(int producers, int jobs, long long& work) {
+    const size_t BATCH = 256;
+    SubmissionQueue<Process> ring(4096);
+    mutex lock;
+    deque<Process> locked;
+    OnlineFcfs engine(BATCH);
+    long long now = 0;
+    int delivered = 0;
+    work = 0;
+    auto run = [&](const Process& job) {
+        work += job.burstTime;
+        Process arrived = job;
+        arrived.arrivalTime = (int)now;
+        engine.submit(arrived);
+        OnlineFcfs::Dispatch dispatch = engine.next(now);
+        now += dispatch.overhead + dispatch.slice;
+        engine.complete(dispatch.job, now);
+        delivered++;
+    };
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (int t = 0; t < producers; t++) {
+        threads.push_back(thread([&, t]() {
+            int begin = (long long)jobs * t / producers, end = (long long)jobs * (t + 1) / producers;
+            for (int i = begin; i < end; i++) {
+                Process job(i + 1, 0, 1 + i % 7);
+                if (Locked) {
+                    lock_guard<mutex> guard(lock);
+                    locked.push_back(job);
+                } else {
+                    while (!ring.tryPush(job)) this_thread::yield();
                 }
             }
-            
-            if (currentProcess.remainingTime == 0) {
-                currentProcess.completionTime = currentTime;
-                currentProcess.turnaroundTime = currentProcess.completionTime - currentProcess.arrivalTime;
-                currentProcess.waitingTime = currentProcess.turnaroundTime - currentProcess.burstTime;
-                completedCount++;
-            } else {
-                readyQueue.push(currentIdx);
+        }));
+    }
+    Process batch[BATCH];
+    while (delivered < jobs) {
+        size_t count = 0;
+        if (Locked) {
+            lock_guard<mutex> guard(lock);
+            while (count < BATCH && !locked.empty()) {
+                batch[count++] = locked.front();
+                locked.pop_front();
             }
+        } else {
+            size_t got = 0;
+            ring.drain([&](const Process& job) { batch[got++] = job; }, BATCH);
+            count = got;
         }
-        
-        return processes;
+        for (size_t k = 0; k < count; k++) run(batch[k]);
+        if (count == 0) this_thread::yield();
     }
-    
-    static vector<Process> priority(vector<Process> processes) {
-        vector<bool> isCompleted(processes.size(), false);
-        int currentTime = 0;
-        int completedCount = 0;
-        
-        while (completedCount < processes.size()) {
-            int highestPriorityIdx = -1;
-            int highestPriority = INT_MAX;
-            
-            for (int i = 0; i < processes.size(); i++) {
-                if (!isCompleted[i] && processes[i].arrivalTime <= currentTime &&
-                    processes[i].priority < highestPriority) {
-                    highestPriority = processes[i].priority;
-                    highestPriorityIdx = i;
+    for (auto& producer : threads) producer.join();
+    return jobs / chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void benchmarkSubmission(int jobs) {
+    if (jobs <= 0) jobs = 1;
+    cout << "\nSubmission Queue Benchmark (" << jobs << " jobs, batches of 256, "
+         << thread::hardware_concurrency() << " hardware threads)\n";
+    cout << string(62, '=') << "\n";
+    cout << setw(10) << "Producers" << setw(21) << "Lock-free (Mjobs/s)" << setw(20) << "Mutex (Mjobs/s)"
+         << setw(11) << "Work OK\n";
+    cout << string(62, '-') << "\n";
+    long long submitted = 0;
+    for (int i = 0; i < jobs; i++) submitted += 1 + i % 7;
+    for (int producers = 1; producers <= 64; producers *= 2) {
+        long long ringWork = 0, mutexWork = 0;
+        double ring = submissionThroughput<false>(producers, jobs, ringWork);
+        double mutexed = submissionThroughput<true>(producers, jobs, mutexWork);
+        cout << setw(10) << producers << setw(21) << fixed << setprecision(2) << ring / 1e6
+             << setw(20) << mutexed / 1e6
+             << setw(10) << (ringWork == submitted && mutexWork == submitted ? "yes" : "NO") << "\n";
+    }
+}
+
+// Many producers through a deliberately tiny ring so it wraps and fills
+// constantly; the consumer checks every job arrives exactly once and in
+// each producer's order. Meant to run under ThreadSanitizer
+// (-DCPU_SCHED_TSAN=ON). Returns false on the first violation.
+bool stressSubmission(int rounds) {
+    const int PRODUCERS = 16, PER_PRODUCER = 20000;
+    for (int round = 0; round < rounds; round++) {
+        SubmissionQueue<Process> ring(8);
+        vector<thread> threads;
+        for (int t = 0; t < PRODUCERS; t++) {
+            threads.push_back(thread([&, t]() {
+                for (int i = 0; i < PER_PRODUCER; i++) {
+                    Process job(t, i, 1);   // producer in id, sequence in arrivalTime
+                    while (!ring.tryPush(job)) this_thread::yield();
                 }
-            }
-            
-            if (highestPriorityIdx == -1) {
-                currentTime++;
-            } else {
-                Process& process = processes[highestPriorityIdx];
-                process.waitingTime = currentTime - process.arrivalTime;
-                process.completionTime = currentTime + process.burstTime;
-                process.turnaroundTime = process.completionTime - process.arrivalTime;
-                
-                currentTime = process.completionTime;
-                isCompleted[highestPriorityIdx] = true;
-                completedCount++;
-            }
+            }));
+        }
+        vector<int> expected(PRODUCERS, 0);
+        int received = 0;
+        bool ok = true;
+        while (received < PRODUCERS * PER_PRODUCER && ok) {
+            size_t count = ring.drain([&](const Process& job) {
+                if (job.id < 0 || job.id >= PRODUCERS || job.arrivalTime != expected[job.id]++) ok = false;
+            });
+            received += count;
+            if (count == 0) this_thread::yield();
+        }
+        for (auto& producer : threads) producer.join();
+        if (!ok || ring.drain([](const Process&) {}) != 0) {
+            cout << "Round " << round << ": lost, duplicated or reordered job\n";
+            return false;
         }
-        
-        return processes;
     }
-    
-    static double calculateAverageWaitingTime(const vector<Process>& processes) {
-        double total = 0;
-        for (const auto& process : processes) {
-            total += process.waitingTime;
+    cout << rounds << " rounds x " << PRODUCERS << " producers x " << PER_PRODUCER << " jobs: all delivered "
+         << "once, in order\n";
+    return true;
+}
+
+// Fixed quanta against adaptive percentiles on a mixed workload (mostly
+// short interactive bursts, some long batch ones) with a switch cost.
+void benchmarkAdaptiveQuantum(int jobs) {
+    if (jobs <= 0) jobs = 1;
+    vector<Process> processes;
+    processes.reserve(jobs);
+    mt19937 rng(42);
+    int arrival = 0;
+    for (int i = 0; i < jobs; i++) {
+        arrival += rng() % 70;   // about 85% busy
+        int burst = rng() % 5 == 0 ? 50 + rng() % 150 : 1 + rng() % 5;
+        processes.push_back(Process(i + 1, arrival, burst));
+    }
+    SwitchCostModel cost(1);
+
+    cout << "\nAdaptive Quantum Benchmark (" << jobs << " jobs, 80% bursts 1-5, 20% bursts 50-199, switch cost 1)\n";
+    cout << string(82, '=') << "\n";
+    cout << setw(16) << "Quantum" << setw(14) << "Avg Waiting" << setw(16) << "Avg Turnaround" << setw(12)
+         << "Switches" << setw(12) << "Changes" << setw(12) << "Time (ms)\n";
+    cout << string(82, '-') << "\n";
+    vector<Process> result;
+    const int fixed[] = {1, 2, 4, 8, 16, 32, 64};
+    for (int q : fixed) {
+        auto start = chrono::steady_clock::now();
+        CPUScheduler::roundRobin(processes, result, q, cost);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        cout << setw(16) << ("fixed " + to_string(q)) << setw(14) << std::fixed << setprecision(2)
+             << CPUScheduler::calculateAverageWaitingTime(result) << setw(16)
+             << CPUScheduler::calculateAverageTurnaroundTime(result) << setw(12)
+             << CPUScheduler::calculateTotalContextSwitches(result) << setw(12) << "-" << setw(11)
+             << setprecision(1) << ms << "\n";
+    }
+    const int percentiles[] = {25, 50, 75, 90};
+    for (int p : percentiles) {
+        vector<QuantumStep> trajectory;
+        auto start = chrono::steady_clock::now();
+        result = CPUScheduler::adaptiveRoundRobin(processes, p, &trajectory, cost);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        cout << setw(16) << (p == 50 ? string("median") : string("p") + to_string(p)) << setw(14) << std::fixed
+             << setprecision(2) << CPUScheduler::calculateAverageWaitingTime(result) << setw(16)
+             << CPUScheduler::calculateAverageTurnaroundTime(result) << setw(12)
+             << CPUScheduler::calculateTotalContextSwitches(result) << setw(12) << trajectory.size() << setw(11)
+             << setprecision(1) << ms << "\n";
+    }
+}
+
+// Recurring tasks whose CPU bursts hover around a per-task mean that
+// occasionally shifts, scheduled on predicted bursts at several alphas and
+// compared with oracle SJF, which knows every burst in advance.
+void benchmarkPredictedSjf(int tasks) {
+    const int CPU_BURSTS = 20, DEVICES = 2;
+    if (tasks <= 0) tasks = 1;
+    vector<Process> processes;
+    BurstTable bursts;
+    mt19937 rng(42);
+    int arrival = 0;
+    for (int i = 0; i < tasks; i++) {
+        arrival += rng() % 1040;   // about 85% CPU busy
+        processes.push_back(Process(i + 1, arrival, 0));
+        int mean = 2 + rng() % 40;
+        for (int k = 0; k < CPU_BURSTS; k++) {
+            if (rng() % 8 == 0) mean = 2 + rng() % 40;   // phase change
+            bursts.addCpuBurst(max(1, (int)(mean * (50 + rng() % 101) / 100)));
+            if (k + 1 < CPU_BURSTS) bursts.addIoBurst(5 + rng() % 40, rng() % DEVICES);
         }
-        return total / processes.size();
+        bursts.endJob();
     }
+
+    struct Row {
+        const char* name;
+        CpuPolicy policy;
+        double alpha;
+    };
+    const Row rows[] = {{"FCFS", POLICY_FCFS, 0.5},
+                        {"SJF (oracle)", POLICY_SJF, 0.5},
+                        {"SJF alpha 0.2", POLICY_SJF_PREDICTED, 0.2},
+                        {"SJF alpha 0.5", POLICY_SJF_PREDICTED, 0.5},
+                        {"SJF alpha 0.8", POLICY_SJF_PREDICTED, 0.8},
+                        {"SRTF alpha 0.5", POLICY_SRTF_PREDICTED, 0.5}};
+
+    cout << "\nPredicted-Burst SJF Benchmark (" << tasks << " tasks x " << CPU_BURSTS << " CPU bursts, "
+         << DEVICES << " devices, initial estimate 10)\n";
+    cout << string(76, '=') << "\n";
+    cout << setw(16) << "Policy" << setw(14) << "Avg Waiting" << setw(14) << "vs Oracle" << setw(10) << "MAE"
+         << setw(10) << "RMSE" << setw(12) << "Time (ms)" << "\n";
+    cout << string(76, '-') << "\n";
+    double oracle = 0;
+    for (const Row& row : rows) {
+        UtilizationStats stats;
+        BurstPredictor predictor(row.alpha);
+        auto start = chrono::steady_clock::now();
+        vector<Process> result = CPUScheduler::burstSequences(processes, bursts, DEVICES, row.policy, 0, stats,
+                                                              SwitchCostModel(), EVENT_QUEUE_HEAP,
+                                                              CheckpointOptions(), &predictor);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        double waiting = CPUScheduler::calculateAverageWaitingTime(result);
+        if (row.policy == POLICY_SJF) oracle = waiting;
+        bool predicted = row.policy == POLICY_SJF_PREDICTED || row.policy == POLICY_SRTF_PREDICTED;
+        stringstream penalty;
+        if (!predicted) penalty << "-";
+        else penalty << fixed << setprecision(1) << showpos << (oracle > 0 ? (waiting / oracle - 1) * 100 : 0.0) << "%";
+        cout << setw(16) << row.name << setw(14) << fixed << setprecision(2) << waiting << setw(14) << penalty.str();
+        if (predicted) {
+            cout << setw(10) << predictor.meanAbsoluteError() << setw(10) << predictor.rootMeanSquaredError();
+        } else {
+            cout << setw(10) << "-" << setw(10) << "-";
+        }
+        cout << setw(12) << setprecision(1) << ms << "\n";
+    }
+}
+
+// Many small runs back to back, as in a parameter sweep, through the
+// overloads that reuse the caller's result vector and the thread's arena.
+void benchmarkScratchReuse(int runs) {
+    const char* names[] = {"FCFS", "SJF", "Round Robin", "Priority"};
+    WorkloadModel model(50);
+    mt19937_64 rng(42);
+    vector<Process> processes, result;
+    model.generate(rng, processes);
     
-    static double calculateAverageTurnaroundTime(const vector<Process>& processes) {
-        double total = 0;
-        for (const auto& process : processes) {
-            total += process.turnaroundTime;
+    cout << "\nScratch Reuse Benchmark (" << runs << " runs of " << model.jobs << " jobs each)\n";
+    cout << string(62, '=') << "\n";
+    cout << setw(14) << "Engine" << setw(14) << "Runs/sec" << setw(16) << "Arena blocks" << setw(18) << "Bytes/run (last)" << "\n";
+    cout << string(62, '-') << "\n";
+    for (int policy = POLICY_FCFS; policy <= POLICY_PRIORITY; policy++) {
+        auto start = chrono::steady_clock::now();
+        for (int r = 0; r < runs; r++) {
+            if (policy == POLICY_FCFS) CPUScheduler::fcfs(processes, result);
+            else if (policy == POLICY_SJF) CPUScheduler::sjf(processes, result);
+            else if (policy == POLICY_RR) CPUScheduler::roundRobin(processes, result, 2);
+            else CPUScheduler::priority(processes, result);
         }
-        return total / processes.size();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << setw(14) << names[policy] << setw(14) << fixed << setprecision(0) << runs / seconds
+             << setw(16) << SimulationContext::current().heapBlocks();
+        if (EngineCounters::enabled) {
+            cout << setw(18) << EngineCounters::current().allocatedBytes() << "\n";
+        } else {
+            cout << setw(18) << "n/a" << "\n";
+        }
+        ostringstream discard;
+        EngineCounters::current().dump(discard);
+    }
+    if (!EngineCounters::enabled) cout << "Build with -DENGINE_COUNTERS=1 to count bytes allocated per run.\n";
+}
+
+#if CPU_SCHED_COROUTINES
+// Baselines for the coroutine benchmark: a plain FIFO of coroutine handles,
+// and a FIFO executor of callbacks.
+class PlainFifoExecutor {
+public:
+    struct YieldAwaiter {
+        PlainFifoExecutor& executor;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(coroutine_handle<> task) const { executor.ready.push_back(task); }
+        void await_resume() const noexcept {}
+    };
+
+    ~PlainFifoExecutor() {
+        for (auto task : ready) task.destroy();
+    }
+
+    void spawn(Task task) { ready.push_back(task.release()); }
+    YieldAwaiter yield() { return YieldAwaiter{*this}; }
+
+    long long run() {
+        long long resumes = 0;
+        while (!ready.empty()) {
+            coroutine_handle<> task = ready.front();
+            ready.pop_front();
+            task.resume();
+            resumes++;
+            if (task.done()) task.destroy();
+        }
+        return resumes;
     }
+
+private:
+    deque<coroutine_handle<>> ready;
 };
 
-void printResults(const vector<Process>& processes, const string& algorithm) {
-    cout << "\n" << algorithm << " Scheduling Results:\n";
+class CallbackExecutor {
+public:
+    void post(function<void()> task) { tasks.push_back(move(task)); }
+
+    void run() {
+        while (!tasks.empty()) {
+            function<void()> task = move(tasks.front());
+            tasks.pop_front();
+            task();
+        }
+    }
+
+private:
+    deque<function<void()>> tasks;
+};
+
+// A job as a task: runs its burst in slices of `quantum` (0 = all at once)
+// on a shared virtual clock, yielding between slices, and records when it
+// finished.
+template <typename Executor>
+Task clockedJob(Executor& executor, int burst, int quantum, long long& clock, int& finished) {
+    int remaining = burst;
+    while (quantum > 0 && remaining > quantum) {
+        remaining -= quantum;
+        clock += quantum;
+        co_await executor.yield();
+    }
+    clock += remaining;
+    finished = (int)clock;
+}
+
+template <typename Executor>
+vector<int> runClockedJobs(const vector<Process>& processes, int quantum, long long* resumes = nullptr) {
+    Executor executor(processes.size());
+    vector<int> finished(processes.size());
+    long long clock = 0;
+    for (size_t i = 0; i < processes.size(); i++) {
+        executor.spawn(clockedJob(executor, processes[i].burstTime, quantum, clock, finished[i]),
+                       processes[i].burstTime, processes[i].priority);
+    }
+    long long count = executor.run();
+    if (resumes) *resumes = count;
+    return finished;
+}
+
+// Checks that the executors order tasks as CPUScheduler orders jobs that all
+// arrive at once, then times resumes with every task yielding after each
+// unit of work, against the plain coroutine FIFO and the callback FIFO.
+void benchmarkCoroutines(int jobs) {
+    const char* policyNames[] = {"FCFS", "SJF", "Round Robin", "Priority"};
+    const int QUANTUM = 2;
+    mt19937 rng(42);
+    auto workload = [&](int n) {
+        vector<Process> processes;
+        for (int i = 0; i < n; i++) {
+            processes.push_back(Process(i + 1, 0, 1 + rng() % 20, rng() % 8));
+        }
+        return processes;
+    };
+    auto schedule = [](const vector<Process>& processes, int policy, int quantum, long long* resumes) {
+        if (policy == POLICY_SJF) return runClockedJobs<SjfExecutor>(processes, 0, resumes);
+        if (policy == POLICY_RR) return runClockedJobs<RoundRobinExecutor>(processes, quantum, resumes);
+        if (policy == POLICY_PRIORITY) return runClockedJobs<PriorityExecutor>(processes, 0, resumes);
+        return runClockedJobs<FcfsExecutor>(processes, 0, resumes);
+    };
+    
+    cout << "\nCoroutine Executor Benchmark\n";
     cout << string(70, '=') << "\n";
-    cout << setw(8) << "Process" << setw(10) << "Arrival" << setw(8) << "Burst" 
-         << setw(12) << "Completion" << setw(10) << "Waiting" << setw(12) << "Turnaround" << "\n";
+    vector<Process> small = workload(2000);
+    for (int policy = POLICY_FCFS; policy <= POLICY_PRIORITY; policy++) {
+        vector<Process> expected;
+        if (policy == POLICY_FCFS) expected = CPUScheduler::fcfs(small);
+        else if (policy == POLICY_SJF) expected = CPUScheduler::sjf(small);
+        else if (policy == POLICY_RR) expected = CPUScheduler::roundRobin(small, QUANTUM);
+        else expected = CPUScheduler::priority(small);
+        vector<int> finished = schedule(small, policy, QUANTUM, nullptr);
+        bool same = true;
+        for (const auto& e : expected) same = same && finished[e.id - 1] == e.completionTime;
+        cout << setw(12) << policyNames[policy] << " executor matches CPUScheduler on 2000 tasks: "
+             << (same ? "yes" : "NO") << "\n";
+    }
+    
+    cout << "\n" << setw(26) << "Executor (yield per unit)" << setw(14) << "Resumes" << setw(12) << "Time (ms)"
+         << setw(14) << "ns/resume" << "\n";
     cout << string(70, '-') << "\n";
+    vector<Process> large = workload(jobs);
+    auto report = [](const string& name, long long resumes, chrono::steady_clock::time_point start) {
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        cout << setw(26) << name << setw(14) << resumes << setw(12) << fixed << setprecision(1) << ms
+             << setw(14) << ms * 1e6 / max(resumes, 1LL) << "\n";
+    };
+    long long resumes = 0;
+    auto start = chrono::steady_clock::now();
+    runClockedJobs<RoundRobinExecutor>(large, 1, &resumes);
+    report("FIFO (FCFS, RR)", resumes, start);
+    start = chrono::steady_clock::now();
+    runClockedJobs<SjfExecutor>(large, 1, &resumes);
+    report("SJF on burst hints", resumes, start);
+    start = chrono::steady_clock::now();
+    runClockedJobs<PriorityExecutor>(large, 1, &resumes);
+    report("Priority", resumes, start);
     
-    for (const auto& process : processes) {
-        cout << setw(8) << ("P" + to_string(process.id))
-             << setw(10) << process.arrivalTime
-             << setw(8) << process.burstTime
-             << setw(12) << process.completionTime
-             << setw(10) << process.waitingTime
-             << setw(12) << process.turnaroundTime << "\n";
+    start = chrono::steady_clock::now();
+    {
+        PlainFifoExecutor executor;
+        vector<int> finished(large.size());
+        long long clock = 0;
+        for (size_t i = 0; i < large.size(); i++) {
+            executor.spawn(clockedJob(executor, large[i].burstTime, 1, clock, finished[i]));
+        }
+        resumes = executor.run();
     }
+    report("plain coroutine FIFO", resumes, start);
     
-    cout << string(70, '-') << "\n";
-    cout << "Average Waiting Time: " << fixed << setprecision(2) 
-         << CPUScheduler::calculateAverageWaitingTime(processes) << " ms\n";
-    cout << "Average Turnaround Time: " << fixed << setprecision(2) 
-         << CPUScheduler::calculateAverageTurnaroundTime(processes) << " ms\n";
+    CallbackExecutor executor;
+    vector<int> remaining(large.size());
+    long long dispatches = 0, now = 0;
+    function<void(int)> step = [&](int i) {
+        dispatches++;
+        now++;
+        if (--remaining[i] > 0) executor.post([&step, i]() { step(i); });
+    };
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < large.size(); i++) {
+        remaining[i] = large[i].burstTime;
+        executor.post([&step, i]() { step((int)i); });
+    }
+    executor.run();
+    report("callback FIFO", dispatches, start);
 }
+#endif
 
-int main() {
+// tests/engine_tests.cpp includes this file for the engines and brings its own main
+#ifndef CPU_SCHED_NO_MAIN
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench-event-queues") {
+        benchmarkEventQueues();
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-parallel-fcfs") {
+        benchmarkParallelFcfs(argc > 2 ? strtoul(argv[2], 0, 10) : 8000000);
+        return 0;
+    }
+    
+    if (argc > 1 && string(argv[1]) == "--bench-sort") {
+        benchmarkArrivalSort(argc > 2 ? atoi(argv[2]) : 10000000);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-gang") {
+        benchmarkGang(argc > 2 ? atoi(argv[2]) : 100000, argc > 3 ? atoi(argv[3]) : 256);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-cluster") {
+        benchmarkCluster(argc > 2 ? atoi(argv[2]) : 1000, argc > 3 ? atoi(argv[3]) : 1000000,
+                         argc > 4 ? atoi(argv[4]) : 0);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-energy") {
+        benchmarkEnergy(argc > 2 ? atoi(argv[2]) : 1000000);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-online") {
+        benchmarkOnline(argc > 2 ? atoi(argv[2]) : 1000000);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-submit") {
+        benchmarkSubmission(argc > 2 ? atoi(argv[2]) : 4000000);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--stress-submit") {
+        return stressSubmission(argc > 2 ? atoi(argv[2]) : 20) ? 0 : 1;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-adaptive-rr") {
+        benchmarkAdaptiveQuantum(argc > 2 ? atoi(argv[2]) : 200000);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-predicted-sjf") {
+        benchmarkPredictedSjf(argc > 2 ? atoi(argv[2]) : 20000);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-scratch") {
+        benchmarkScratchReuse(argc > 2 ? atoi(argv[2]) : 100000);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-coroutines") {
+#if CPU_SCHED_COROUTINES
+        benchmarkCoroutines(argc > 2 ? atoi(argv[2]) : 1000000);
+#else
+        cout << "Coroutine executor not built: compile with -std=c++20.\n";
+#endif
+        return 0;
+    }
+    if (argc > 2 && string(argv[1]) == "--replay-ftrace") {
+        replayTrace(argv[2], argc > 3 ? atoi(argv[3]) : -1, argc > 4 ? atoi(argv[4]) : 4000);
+        return 0;
+    }
+    
+    TraceWriter trace;
+    ResultsCsv csv;
+    for (int a = 1; a + 1 < argc; a += 2) {
+        if (string(argv[a]) == "--trace") {
+            if (trace.open(argv[a + 1])) {
+                SliceSink::active() = &trace;
+                cout << "Recording every run to trace file '" << argv[a + 1] << "'\n\n";
+            } else {
+                cout << "Cannot write trace file '" << argv[a + 1] << "'\n\n";
+            }
+        } else if (string(argv[a]) == "--csv") {
+            if (csv.open(argv[a + 1])) {
+                ResultsCsv::active() = &csv;
+                cout << "Writing every result table to CSV file '" << argv[a + 1] << "'\n\n";
+            } else {
+                cout << "Cannot write CSV file '" << argv[a + 1] << "'\n\n";
+            }
+        }
+    }
+    
     cout << "CPU Scheduling Algorithm Simulator - Console Version\n";
     cout << string(55, '=') << "\n\n";
     
     vector<Process> processes;
+    SwitchCostModel costModel;
+    CheckpointOptions checkpoint;
     
     cout << "Enter number of processes: ";
     int n;
     cin >> n;
     
     for (int i = 0; i < n; i++) {
-        int arrival, burst, priority;
+        int arrival, burst, priority, deadline, period;
         cout << "\nProcess " << (i + 1) << ":\n";
         cout << "Arrival Time: ";
         cin >> arrival;
@@ -242,8 +4316,12 @@ int main() {
         cin >> burst;
         cout << "Priority (lower number = higher priority): ";
         cin >> priority;
+        cout << "Relative Deadline (0 = none): ";
+        cin >> deadline;
+        cout << "Period (0 = one-shot): ";
+        cin >> period;
         
-        processes.emplace_back(i + 1, arrival, burst, priority);
+        processes.emplace_back(i + 1, arrival, burst, priority, deadline, period);
     }
     
     while (true) {
@@ -253,8 +4331,19 @@ int main() {
         cout << "2. Shortest Job First (SJF)\n";
         cout << "3. Round Robin (RR)\n";
         cout << "4. Priority Scheduling\n";
-        cout << "5. Compare All Algorithms\n";
-        cout << "6. Exit\n";
+        cout << "5. Completely Fair Scheduler (CFS)\n";
+        cout << "6. Earliest Deadline First (EDF)\n";
+        cout << "7. Rate Monotonic (RM)\n";
+        cout << "8. Compare All Algorithms\n";
+        cout << "9. CPU/I-O Burst Simulation\n";
+        cout << "10. Configure Context-Switch Cost\n";
+        cout << "11. Configure Checkpointing (CFS, EDF, RM, CPU/I-O)\n";
+        cout << "12. Monte Carlo Evaluation\n";
+        cout << "13. Live Execution (spin on real cores)\n";
+        cout << "14. Gang Scheduling (multi-threaded jobs on N cores)\n";
+        cout << "15. Cluster Simulation (many nodes, dispatch and migration)\n";
+        cout << "16. Energy-Aware Scheduling (DVFS)\n";
+        cout << "17. Exit\n";
         cout << "Enter your choice: ";
         
         int choice;
@@ -262,54 +4351,361 @@ int main() {
         
         switch (choice) {
             case 1: {
-                auto result = CPUScheduler::fcfs(processes);
+                auto result = CPUScheduler::fcfs(processes, costModel);
                 printResults(result, "FCFS");
                 break;
             }
             case 2: {
-                auto result = CPUScheduler::sjf(processes);
+                auto result = CPUScheduler::sjf(processes, costModel);
                 printResults(result, "SJF");
                 break;
             }
             case 3: {
                 int quantum;
-                cout << "Enter time quantum: ";
+                cout << "Enter time quantum (0 = adaptive): ";
                 cin >> quantum;
-                auto result = CPUScheduler::roundRobin(processes, quantum);
+                if (quantum <= 0) {
+                    double percentile;
+                    cout << "Percentile of queued remaining bursts (50 = median): ";
+                    cin >> percentile;
+                    vector<QuantumStep> trajectory;
+                    auto result = CPUScheduler::adaptiveRoundRobin(processes, percentile, &trajectory, costModel);
+                    stringstream name;
+                    name << "Round Robin (adaptive, p" << percentile << ")";
+                    printResults(result, name.str());
+                    printQuantumTrajectory(trajectory);
+                    break;
+                }
+                auto result = CPUScheduler::roundRobin(processes, quantum, costModel);
                 printResults(result, "Round Robin (q=" + to_string(quantum) + ")");
                 break;
             }
             case 4: {
-                auto result = CPUScheduler::priority(processes);
+                auto result = CPUScheduler::priority(processes, costModel);
                 printResults(result, "Priority");
                 break;
             }
             case 5: {
+                int targetLatency, minGranularity;
+                cout << "Enter target latency: ";
+                cin >> targetLatency;
+                cout << "Enter minimum granularity: ";
+                cin >> minGranularity;
+                try {
+                    auto result = CPUScheduler::cfs(processes, targetLatency, minGranularity, costModel, checkpoint);
+                    printResults(result, "CFS (latency=" + to_string(targetLatency) +
+                                         ", gran=" + to_string(minGranularity) + ")");
+                } catch (const overflow_error& error) {
+                    cout << error.what() << "; use a coarser time unit.\n";
+                }
+                break;
+            }
+            case 6:
+            case 7: {
+                int horizon;
+                cout << "Enter simulation horizon (0 = hyperperiod): ";
+                cin >> horizon;
+                if (horizon <= 0) horizon = CPUScheduler::hyperperiod(processes);
+                DeadlineStats stats;
+                if (choice == 6) {
+                    auto result = CPUScheduler::edf(processes, horizon, stats, costModel, checkpoint);
+                    printResults(result, "EDF (horizon=" + to_string(horizon) + ")");
+                } else {
+                    auto result = CPUScheduler::rateMonotonic(processes, horizon, stats, costModel, checkpoint);
+                    printResults(result, "Rate Monotonic (horizon=" + to_string(horizon) + ")");
+                }
+                printDeadlineStats(stats);
+                break;
+            }
+            case 8: {
                 cout << "\nAlgorithm Comparison:\n";
                 cout << string(50, '=') << "\n";
                 
-                auto fcfsResult = CPUScheduler::fcfs(processes);
-                auto sjfResult = CPUScheduler::sjf(processes);
-                auto rrResult = CPUScheduler::roundRobin(processes, 2);
-                auto priorityResult = CPUScheduler::priority(processes);
+                auto fcfsResult = CPUScheduler::fcfs(processes, costModel);
+                auto sjfResult = CPUScheduler::sjf(processes, costModel);
+                auto rrResult = CPUScheduler::roundRobin(processes, 2, costModel);
+                auto priorityResult = CPUScheduler::priority(processes, costModel);
+                vector<Process> cfsResult;
+                try {
+                    cfsResult = CPUScheduler::cfs(processes, 6, 1, costModel);
+                } catch (const overflow_error& error) {
+                    cout << error.what() << "; use a coarser time unit.\n";
+                    break;
+                }
+                const pair<const char*, const vector<Process>*> runs[] = {
+                    {"FCFS", &fcfsResult}, {"SJF", &sjfResult}, {"Round Robin (q=2)", &rrResult},
+                    {"Priority", &priorityResult}, {"CFS", &cfsResult}};
                 
-                cout << setw(20) << "Algorithm" << setw(15) << "Avg Waiting" << setw(15) << "Avg Turnaround" << "\n";
-                cout << string(50, '-') << "\n";
-                cout << setw(20) << "FCFS" << setw(15) << fixed << setprecision(2) 
-                     << CPUScheduler::calculateAverageWaitingTime(fcfsResult) << setw(15) 
-                     << CPUScheduler::calculateAverageTurnaroundTime(fcfsResult) << "\n";
-                cout << setw(20) << "SJF" << setw(15) << fixed << setprecision(2) 
-                     << CPUScheduler::calculateAverageWaitingTime(sjfResult) << setw(15) 
-                     << CPUScheduler::calculateAverageTurnaroundTime(sjfResult) << "\n";
-                cout << setw(20) << "Round Robin (q=2)" << setw(15) << fixed << setprecision(2) 
-                     << CPUScheduler::calculateAverageWaitingTime(rrResult) << setw(15) 
-                     << CPUScheduler::calculateAverageTurnaroundTime(rrResult) << "\n";
-                cout << setw(20) << "Priority" << setw(15) << fixed << setprecision(2) 
-                     << CPUScheduler::calculateAverageWaitingTime(priorityResult) << setw(15) 
-                     << CPUScheduler::calculateAverageTurnaroundTime(priorityResult) << "\n";
+                cout << setw(20) << "Algorithm" << setw(12) << "Avg Waiting" << setw(12) << "Max Waiting"
+                     << setw(15) << "Avg Turnaround" << setw(13) << "Avg Response" << setw(12) << "Throughput"
+                     << setw(10) << "CPU Util" << setw(10) << "Slowdown" << setw(10) << "Fairness"
+                     << setw(17) << "Switch Overhead" << "\n";
+                cout << string(131, '-') << "\n";
+                for (const auto& run : runs) {
+                    ScheduleMetrics metrics = ScheduleMetrics::of(*run.second);
+                    cout << setw(20) << run.first << setw(12) << fixed << setprecision(2) << metrics.averageWaiting
+                         << setw(12) << metrics.maxWaiting << setw(15) << metrics.averageTurnaround << setw(13)
+                         << metrics.averageResponse << setw(12) << setprecision(4) << metrics.throughput
+                         << setw(9) << setprecision(1) << metrics.cpuUtilization * 100 << "%" << setw(10)
+                         << setprecision(2) << metrics.averageSlowdown << setw(10) << setprecision(3)
+                         << metrics.fairness << setw(17) << CPUScheduler::calculateTotalSwitchOverhead(*run.second)
+                         << "\n";
+                    if (ResultsCsv::active()) {
+                        ResultsCsv::active()->write(*run.second, string("Compare All - ") + run.first, metrics);
+                    }
+                }
+                EngineCounters::current().dump(cout);
                 break;
             }
-            case 6:
+            case 9: {
+                int numDevices, policy, quantum = 0;
+                cout << "Number of I/O devices: ";
+                cin >> numDevices;
+                if (numDevices <= 0) numDevices = 1;
+                
+                BurstTable bursts;
+                for (const auto& process : processes) {
+                    int count;
+                    cout << "\nP" << process.id << " - number of bursts (CPU, I/O, CPU, ...): ";
+                    cin >> count;
+                    for (int k = 0; k < max(count, 1); k++) {
+                        int length, device = 0;
+                        if (k % 2 == 0) {
+                            cout << "  CPU burst: ";
+                            cin >> length;
+                            bursts.addCpuBurst(length);
+                        } else {
+                            cout << "  I/O burst: ";
+                            cin >> length;
+                            if (numDevices > 1) {
+                                cout << "  Device (0-" << numDevices - 1 << "): ";
+                                cin >> device;
+                                device = max(0, min(numDevices - 1, device));
+                            }
+                            bursts.addIoBurst(length, device);
+                        }
+                    }
+                    bursts.endJob();
+                }
+                
+                cout << "CPU policy (1=FCFS, 2=SJF, 3=RR, 4=Priority, 5=SJF predicted, 6=SRTF predicted): ";
+                cin >> policy;
+                CpuPolicy cpuPolicy = policy >= 2 && policy <= 6 ? (CpuPolicy)(policy - 1) : POLICY_FCFS;
+                if (cpuPolicy == POLICY_RR) {
+                    cout << "Enter time quantum: ";
+                    cin >> quantum;
+                }
+                bool predicted = cpuPolicy == POLICY_SJF_PREDICTED || cpuPolicy == POLICY_SRTF_PREDICTED;
+                BurstPredictor predictor;
+                if (predicted) {
+                    cout << "Smoothing factor alpha (0-1): ";
+                    cin >> predictor.alpha;
+                    predictor.alpha = max(0.0, min(1.0, predictor.alpha));
+                    cout << "Initial burst estimate: ";
+                    cin >> predictor.initialBurst;
+                }
+                
+                int queueChoice;
+                cout << "Event list (1=Binary Heap, 2=Calendar Queue, 3=Timing Wheel): ";
+                cin >> queueChoice;
+                EventQueueKind queueKind = queueChoice == 2 ? EVENT_QUEUE_CALENDAR
+                                         : queueChoice == 3 ? EVENT_QUEUE_WHEEL : EVENT_QUEUE_HEAP;
+                
+                const char* policyNames[] = {"FCFS", "SJF", "Round Robin", "Priority", "SJF (predicted)",
+                                             "SRTF (predicted)"};
+                UtilizationStats stats;
+                auto result = CPUScheduler::burstSequences(processes, bursts, numDevices, cpuPolicy, quantum,
+                                                           stats, costModel, queueKind, checkpoint, &predictor);
+                printResults(result, string("CPU/I-O Bursts - ") + policyNames[cpuPolicy]);
+                printUtilization(stats);
+                if (predicted) {
+                    UtilizationStats oracleStats;
+                    auto oracle = CPUScheduler::burstSequences(processes, bursts, numDevices, POLICY_SJF, 0,
+                                                               oracleStats, costModel, queueKind);
+                    printPrediction(predictor, CPUScheduler::calculateAverageWaitingTime(result),
+                                    CPUScheduler::calculateAverageWaitingTime(oracle));
+                }
+                break;
+            }
+            case 10:
+                cout << "Fixed cost per switch: ";
+                cin >> costModel.switchCost;
+                cout << "Maximum cache-refill penalty: ";
+                cin >> costModel.maxCacheRefill;
+                cout << "Time off-CPU until cache is cold (0 = always cold): ";
+                cin >> costModel.cacheColdTime;
+                break;
+            case 11: {
+                char resume;
+                cout << "Snapshot file: ";
+                cin >> checkpoint.path;
+                cout << "Simulated time between snapshots (0 = off): ";
+                cin >> checkpoint.interval;
+                cout << "Resume from existing snapshot (y/n): ";
+                cin >> resume;
+                checkpoint.resume = (resume == 'y' || resume == 'Y');
+                break;
+            }
+            case 12: {
+                WorkloadModel model;
+                MonteCarloOptions options;
+                cout << "Jobs per replication: ";
+                cin >> model.jobs;
+                cout << "Mean inter-arrival time: ";
+                cin >> model.meanInterarrival;
+                cout << "Mean burst time: ";
+                cin >> model.meanBurst;
+                cout << "Priority levels: ";
+                cin >> model.priorityLevels;
+                cout << "Target relative CI half-width (e.g. 0.02): ";
+                cin >> options.relativePrecision;
+                cout << "Maximum replications: ";
+                cin >> options.maxReplications;
+                if (model.jobs <= 0 || model.meanInterarrival <= 0 || model.meanBurst <= 0) {
+                    cout << "Invalid workload model!\n";
+                    break;
+                }
+                options.costModel = costModel;
+                printMonteCarlo(MonteCarlo::run(model, options));
+                break;
+            }
+            case 13: {
+                int policy, quantum = 0, workers;
+                cout << "Policy (1 = FCFS, 2 = SJF, 3 = Round Robin, 4 = Priority): ";
+                cin >> policy;
+                if (policy < 1 || policy > 4) {
+                    cout << "Invalid policy!\n";
+                    break;
+                }
+                if (policy == 3) {
+                    cout << "Time quantum (microseconds): ";
+                    cin >> quantum;
+                    if (quantum <= 0) {
+                        cout << "Invalid time quantum!\n";
+                        break;
+                    }
+                }
+                cout << "Worker threads (1 matches the single simulated CPU): ";
+                cin >> workers;
+                int cores = max(1, (int)thread::hardware_concurrency());
+                if (workers > cores) {
+                    cout << "Only " << cores << " hardware threads; using " << cores << " workers.\n";
+                    workers = cores;
+                }
+                cout << "Times are microseconds; running...\n";
+                
+                // the live run pays real switch costs only, so the baseline charges none
+                const char* policyNames[] = {"FCFS", "SJF", "Round Robin", "Priority"};
+                CpuPolicy cpuPolicy = (CpuPolicy)(policy - 1);
+                SwitchCostModel noCost;
+                vector<Process> simulated;
+                if (cpuPolicy == POLICY_FCFS) simulated = CPUScheduler::fcfs(processes, noCost);
+                else if (cpuPolicy == POLICY_SJF) simulated = CPUScheduler::sjf(processes, noCost);
+                else if (cpuPolicy == POLICY_RR) simulated = CPUScheduler::roundRobin(processes, quantum, noCost);
+                else simulated = CPUScheduler::priority(processes, noCost);
+                vector<Process> live = LiveExecutor::run(processes, cpuPolicy, quantum, workers);
+                printLiveComparison(live, simulated, policyNames[cpuPolicy]);
+                break;
+            }
+            case 14: {
+                int cores;
+                char backfill;
+                cout << "Number of cores: ";
+                cin >> cores;
+                cout << "Backfill (y/n): ";
+                cin >> backfill;
+                for (auto& process : processes) {
+                    cout << "Threads for P" << process.id << ": ";
+                    cin >> process.threads;
+                }
+                
+                GangStats stats;
+                vector<Process> result = CPUScheduler::gang(processes, cores, backfill == 'y' || backfill == 'Y',
+                                                            stats, costModel);
+                printResults(result, "Gang", cores);
+                printGangStats(stats);
+                break;
+            }
+            case 15: {
+                ClusterOptions options;
+                int policy, rule;
+                char migrate;
+                cout << "Number of nodes: ";
+                cin >> options.nodes;
+                cout << "Policy on each node (1 = FCFS, 2 = SJF, 3 = Round Robin, 4 = Priority): ";
+                cin >> policy;
+                if (options.nodes <= 0 || policy < 1 || policy > 4) {
+                    cout << "Invalid cluster settings!\n";
+                    break;
+                }
+                options.policy = (CpuPolicy)(policy - 1);
+                if (options.policy == POLICY_RR) {
+                    cout << "Time quantum: ";
+                    cin >> options.timeQuantum;
+                    if (options.timeQuantum <= 0) {
+                        cout << "Invalid time quantum!\n";
+                        break;
+                    }
+                }
+                cout << "Dispatch (1 = Round Robin, 2 = Least Loaded, 3 = Power of Two): ";
+                cin >> rule;
+                options.dispatch = (DispatchRule)(max(1, min(3, rule)) - 1);
+                cout << "Sync interval: ";
+                cin >> options.syncInterval;
+                cout << "Migrate queued jobs (y/n): ";
+                cin >> migrate;
+                options.migrate = migrate == 'y' || migrate == 'Y';
+                if (options.migrate) {
+                    cout << "Migration cost: ";
+                    cin >> options.migrationCost;
+                }
+                options.costModel = costModel;
+                
+                ClusterStats stats;
+                vector<Process> result = ClusterSimulator::run(processes, options, stats);
+                printResults(result, string("Cluster (") + ClusterSimulator::dispatchName(options.dispatch) + ")",
+                             options.nodes);
+                printClusterStats(stats);
+                break;
+            }
+            case 16: {
+                int policy, quantum = 2;
+                DvfsModel dvfs;
+                cout << "Policy (1 = FCFS, 2 = SJF, 3 = Round Robin, 4 = Priority): ";
+                cin >> policy;
+                if (policy < 1 || policy > 4) {
+                    cout << "Invalid policy!\n";
+                    break;
+                }
+                if (policy == 3) {
+                    cout << "Enter time quantum: ";
+                    cin >> quantum;
+                    if (quantum <= 0) {
+                        cout << "Invalid time quantum!\n";
+                        break;
+                    }
+                }
+                cout << "Stretch budget with jobs waiting (0 = only idle slack, 0.5 = up to 1.5x): ";
+                cin >> dvfs.maxStretch;
+                
+                const char* policyNames[] = {"FCFS", "SJF", "Round Robin", "Priority"};
+                CpuPolicy cpuPolicy = (CpuPolicy)(policy - 1);
+                EnergyStats perf, aware;
+                vector<Process> fast = CPUScheduler::energyAware(processes, cpuPolicy, quantum, dvfs,
+                                                                 GOVERNOR_PERFORMANCE, perf, costModel);
+                vector<Process> result = CPUScheduler::energyAware(processes, cpuPolicy, quantum, dvfs,
+                                                                   GOVERNOR_ENERGY_AWARE, aware, costModel);
+                printResults(result, string(policyNames[cpuPolicy]) + " (energy-aware DVFS)");
+                printEnergyStats(aware, dvfs);
+                cout << "\nAt top frequency: " << fixed << setprecision(3) << perf.joules() << " J, EDP "
+                     << perf.energyDelayProduct() << " J*s, avg waiting " << setprecision(2)
+                     << CPUScheduler::calculateAverageWaitingTime(fast) << " ms\n";
+                cout << "Energy-aware:     " << setprecision(3) << aware.joules() << " J, EDP "
+                     << aware.energyDelayProduct() << " J*s, avg waiting " << setprecision(2)
+                     << CPUScheduler::calculateAverageWaitingTime(result) << " ms\n";
+                break;
+            }
+            case 17:
                 cout << "Thank you for using CPU Scheduler Simulator!\n";
                 return 0;
             default:
@@ -319,3 +4715,4 @@ int main() {
     
     return 0;
 }
+#endif
@@ -8,6 +8,7 @@
 #include <string>
 #include <cstdlib>
 #include <ctime>
+#include "scheduler_core.h"
 #include <windows.h>
 #include <commctrl.h>
 
@@ -16,31 +17,22 @@
 #pragma comment(lib, "user32.lib")
 
 using namespace std;
-struct Process {
-    int id;
-    int arrivalTime;
-    int burstTime;
-    int priority;
-    int waitingTime;
-    int turnaroundTime;
-    int completionTime;
-    int remainingTime;
-
-    Process() : id(0), arrivalTime(0), burstTime(0), priority(0),
-                waitingTime(0), turnaroundTime(0), completionTime(0), remainingTime(0) {}
-
-    Process(int i, int at, int bt, int p = 0)
-        : id(i), arrivalTime(at), burstTime(bt), priority(p),
-          waitingTime(0), turnaroundTime(0), completionTime(0), remainingTime(bt) {}
-};
-struct GanttEntry {
-    int processId;
-    int startTime;
-    int endTime;
+// Collects the slices of every run on this thread while it is in scope,
+// which is how the GUI gets its Gantt chart from the shared engines.
+class GanttRecorder : public SliceSink {
+public:
+    GanttRecorder() : previous(SliceSink::active()) { SliceSink::active() = this; }
+    ~GanttRecorder() { SliceSink::active() = previous; }
+
+    void beginRun(const char*) {}
+    void slice(const GanttEntry& entry) { entries.push_back(entry); }
 
-    GanttEntry(int pid, int start, int end)
-        : processId(pid), startTime(start), endTime(end) {}
+    vector<GanttEntry> entries;
+
+private:
+    SliceSink* previous;
 };
+
 #define ID_ARRIVAL_EDIT     1001
 #define ID_BURST_EDIT       1002
 #define ID_PRIORITY_EDIT    1003
@@ -55,10 +47,15 @@ struct GanttEntry {
 #define ID_PROCESS_LIST     1012
 #define ID_RESULTS_LIST     1013
 #define ID_METRICS_STATIC   1014
+#define ID_SWITCH_COST_EDIT 1015
+#define ID_CACHE_REFILL_EDIT 1016
+#define ID_CACHE_COLD_EDIT  1017
+#define ID_ADAPTIVE_EDIT    1018
 
 // Global variables
 HWND hMainWindow;
-HWND hArrivalEdit, hBurstEdit, hPriorityEdit, hQuantumEdit;
+HWND hArrivalEdit, hBurstEdit, hPriorityEdit, hQuantumEdit, hAdaptiveEdit;
+HWND hSwitchCostEdit, hCacheRefillEdit, hCacheColdEdit;
 HWND hProcessList, hResultsList, hMetricsStatic;
 vector<Process> processes;
 vector<Process> lastResults;
@@ -70,174 +67,53 @@ string lastAlgorithm;
  */
 class CPUScheduler {
 public:
-    // [Same scheduling algorithms as before - FCFS, SJF, RR, Priority]
-    static pair<vector<Process>, vector<GanttEntry>> fcfs(vector<Process> processes) {
-        vector<GanttEntry> gantt;
-
-        sort(processes.begin(), processes.end(),
-             [](const Process& a, const Process& b) {
-                 return a.arrivalTime < b.arrivalTime;
-             });
-
-        int currentTime = 0;
-
-        for (auto& process : processes) {
-            if (currentTime < process.arrivalTime) {
-                currentTime = process.arrivalTime;
-            }
-
-            process.waitingTime = currentTime - process.arrivalTime;
-            process.completionTime = currentTime + process.burstTime;
-            process.turnaroundTime = process.completionTime - process.arrivalTime;
-
-            gantt.emplace_back(process.id, currentTime, process.completionTime);
-
-            currentTime = process.completionTime;
-        }
-
-        return {processes, gantt};
+    // Engines come from scheduler_core.h; each returns results and Gantt chart.
+    static pair<vector<Process>, vector<GanttEntry>> fcfs(vector<Process> processes,
+                                                          const SwitchCostModel& costModel = SwitchCostModel()) {
+        GanttRecorder gantt;
+        stable_sort(processes.begin(), processes.end(),
+                    [](const Process& a, const Process& b) {
+                        return a.arrivalTime < b.arrivalTime;
+                    });
+        FcfsEngine::run(processes, RunToCompletion(), costModel, "FCFS");
+        return {processes, gantt.entries};
     }
 
-    static pair<vector<Process>, vector<GanttEntry>> sjf(vector<Process> processes) {
-        vector<GanttEntry> gantt;
-        vector<Process> completed;
-        vector<bool> isCompleted(processes.size(), false);
-
-        int currentTime = 0;
-        int completedCount = 0;
-
-        while (completedCount < processes.size()) {
-            int shortestIdx = -1;
-            int shortestBurst = INT_MAX;
-
-            for (int i = 0; i < processes.size(); i++) {
-                if (!isCompleted[i] && processes[i].arrivalTime <= currentTime &&
-                    processes[i].burstTime < shortestBurst) {
-                    shortestBurst = processes[i].burstTime;
-                    shortestIdx = i;
-                }
-            }
-
-            if (shortestIdx == -1) {
-                currentTime++;
-            } else {
-                Process& process = processes[shortestIdx];
-
-                process.waitingTime = currentTime - process.arrivalTime;
-                process.completionTime = currentTime + process.burstTime;
-                process.turnaroundTime = process.completionTime - process.arrivalTime;
-
-                gantt.emplace_back(process.id, currentTime, process.completionTime);
-
-                currentTime = process.completionTime;
-                isCompleted[shortestIdx] = true;
-                completedCount++;
-            }
-        }
-
-        return {processes, gantt};
+    static pair<vector<Process>, vector<GanttEntry>> sjf(vector<Process> processes,
+                                                         const SwitchCostModel& costModel = SwitchCostModel()) {
+        GanttRecorder gantt;
+        SjfEngine::run(processes, RunToCompletion(), costModel, "SJF");
+        return {processes, gantt.entries};
     }
 
-    static pair<vector<Process>, vector<GanttEntry>> roundRobin(vector<Process> processes, int timeQuantum) {
-        vector<GanttEntry> gantt;
-        queue<int> readyQueue;
-        vector<bool> inQueue(processes.size(), false);
-
-        for (auto& process : processes) {
-            process.remainingTime = process.burstTime;
-        }
-
-        int currentTime = 0;
-        int completedCount = 0;
-
-        for (int i = 0; i < processes.size(); i++) {
-            if (processes[i].arrivalTime <= currentTime) {
-                readyQueue.push(i);
-                inQueue[i] = true;
-            }
-        }
-
-        while (completedCount < processes.size()) {
-            if (readyQueue.empty()) {
-                currentTime++;
-                for (int i = 0; i < processes.size(); i++) {
-                    if (!inQueue[i] && processes[i].arrivalTime <= currentTime) {
-                        readyQueue.push(i);
-                        inQueue[i] = true;
-                    }
-                }
-                continue;
-            }
-
-            int currentIdx = readyQueue.front();
-            readyQueue.pop();
-            Process& currentProcess = processes[currentIdx];
-
-            int execTime = min(timeQuantum, currentProcess.remainingTime);
-            int startTime = currentTime;
-            currentTime += execTime;
-            currentProcess.remainingTime -= execTime;
-
-            gantt.emplace_back(currentProcess.id, startTime, currentTime);
-
-            for (int i = 0; i < processes.size(); i++) {
-                if (!inQueue[i] && processes[i].arrivalTime <= currentTime &&
-                    processes[i].remainingTime > 0) {
-                    readyQueue.push(i);
-                    inQueue[i] = true;
-                }
-            }
-
-            if (currentProcess.remainingTime == 0) {
-                currentProcess.completionTime = currentTime;
-                currentProcess.turnaroundTime = currentProcess.completionTime - currentProcess.arrivalTime;
-                currentProcess.waitingTime = currentProcess.turnaroundTime - currentProcess.burstTime;
-                completedCount++;
-            } else {
-                readyQueue.push(currentIdx);
-            }
-        }
-
-        return {processes, gantt};
+    static pair<vector<Process>, vector<GanttEntry>> roundRobin(vector<Process> processes, int timeQuantum,
+                                                                const SwitchCostModel& costModel = SwitchCostModel()) {
+        GanttRecorder gantt;
+        RoundRobinEngine::run(processes, QuantumExpiry(timeQuantum), costModel, "Round Robin");
+        return {processes, gantt.entries};
     }
 
-    static pair<vector<Process>, vector<GanttEntry>> priority(vector<Process> processes) {
-        vector<GanttEntry> gantt;
-        vector<bool> isCompleted(processes.size(), false);
-
-        int currentTime = 0;
-        int completedCount = 0;
-
-        while (completedCount < processes.size()) {
-            int highestPriorityIdx = -1;
-            int highestPriority = INT_MAX;
-
-            for (int i = 0; i < processes.size(); i++) {
-                if (!isCompleted[i] && processes[i].arrivalTime <= currentTime &&
-                    processes[i].priority < highestPriority) {
-                    highestPriority = processes[i].priority;
-                    highestPriorityIdx = i;
-                }
-            }
-
-            if (highestPriorityIdx == -1) {
-                currentTime++;
-            } else {
-                Process& process = processes[highestPriorityIdx];
-
-                process.waitingTime = currentTime - process.arrivalTime;
-                process.completionTime = currentTime + process.burstTime;
-                process.turnaroundTime = process.completionTime - process.arrivalTime;
+    static pair<vector<Process>, vector<GanttEntry>> adaptiveRoundRobin(vector<Process> processes, int percentile,
+                                                                        vector<QuantumStep>& trajectory,
+                                                                        const SwitchCostModel& costModel = SwitchCostModel()) {
+        GanttRecorder gantt;
+        AdaptiveRoundRobinEngine::run(processes, percentile, costModel, &trajectory);
+        return {processes, gantt.entries};
+    }
 
-                gantt.emplace_back(process.id, currentTime, process.completionTime);
+    static pair<vector<Process>, vector<GanttEntry>> priority(vector<Process> processes,
+                                                              const SwitchCostModel& costModel = SwitchCostModel()) {
+        GanttRecorder gantt;
+        PriorityEngine::run(processes, RunToCompletion(), costModel, "Priority");
+        return {processes, gantt.entries};
+    }
 
-                currentTime = process.completionTime;
-                isCompleted[highestPriorityIdx] = true;
-                completedCount++;
-            }
+    static long long calculateTotalSwitchOverhead(const vector<Process>& processes) {
+        long long total = 0;
+        for (const auto& process : processes) {
+            total += process.switchOverhead();
         }
-
-        return {processes, gantt};
+        return total;
     }
 
     static double calculateAverageWaitingTime(const vector<Process>& processes) {
@@ -323,50 +199,95 @@ void UpdateResultsList() {
         // Turnaround Time
         string turnaround = to_string(lastResults[i].turnaroundTime);
         ListView_SetItemText(hResultsList, i, 5, (LPSTR)turnaround.c_str());
+
+        // Response Time
+        string response = to_string(lastResults[i].responseTime());
+        ListView_SetItemText(hResultsList, i, 6, (LPSTR)response.c_str());
     }
 
     // Update metrics
     if (!lastResults.empty()) {
-        double avgWaiting = CPUScheduler::calculateAverageWaitingTime(lastResults);
-        double avgTurnaround = CPUScheduler::calculateAverageTurnaroundTime(lastResults);
+        ScheduleMetrics metrics = ScheduleMetrics::of(lastResults);
 
         stringstream ss;
         ss << "Algorithm: " << lastAlgorithm << " | ";
-        ss << "Avg Waiting: " << fixed << setprecision(2) << avgWaiting << " ms | ";
-        ss << "Avg Turnaround: " << fixed << setprecision(2) << avgTurnaround << " ms";
+        ss << "Avg Waiting: " << fixed << setprecision(2) << metrics.averageWaiting << " ms (max "
+           << metrics.maxWaiting << ") | ";
+        ss << "Avg Turnaround: " << fixed << setprecision(2) << metrics.averageTurnaround << " ms | ";
+        ss << "Avg Response: " << metrics.averageResponse << " ms";
+
+        long long overhead = CPUScheduler::calculateTotalSwitchOverhead(lastResults);
+        if (overhead > 0) {
+            ss << " | Switch Overhead: " << overhead << " ms";
+        }
+        ss << "\nThroughput: " << setprecision(3) << metrics.throughput << " jobs/ms (" << metrics.peakWindowJobs
+           << " peak, " << metrics.lowWindowJobs << " low per " << metrics.window << " ms) | CPU Util: "
+           << setprecision(1) << metrics.cpuUtilization * 100 << "% | Avg Slowdown: " << setprecision(2)
+           << metrics.averageSlowdown << " | Jain's Fairness: " << setprecision(3) << metrics.fairness;
 
         SetWindowText(hMetricsStatic, ss.str().c_str());
     }
 }
 
+SwitchCostModel ReadSwitchCostModel() {
+    char buffer[10];
+    SwitchCostModel model;
+    GetWindowText(hSwitchCostEdit, buffer, 10);
+    model.switchCost = max(0, atoi(buffer));
+    GetWindowText(hCacheRefillEdit, buffer, 10);
+    model.maxCacheRefill = max(0, atoi(buffer));
+    GetWindowText(hCacheColdEdit, buffer, 10);
+    model.cacheColdTime = max(0, atoi(buffer));
+    return model;
+}
+
 void RunAlgorithm(const string& algorithm) {
     if (processes.empty()) {
         MessageBox(hMainWindow, "Please add some processes first!", "No Processes", MB_OK | MB_ICONWARNING);
         return;
     }
 
+    SwitchCostModel costModel = ReadSwitchCostModel();
+
     if (algorithm == "FCFS") {
-        auto result = CPUScheduler::fcfs(processes);
+        auto result = CPUScheduler::fcfs(processes, costModel);
         lastResults = result.first;
         lastGantt = result.second;
         lastAlgorithm = "FCFS";
     } else if (algorithm == "SJF") {
-        auto result = CPUScheduler::sjf(processes);
+        auto result = CPUScheduler::sjf(processes, costModel);
         lastResults = result.first;
         lastGantt = result.second;
         lastAlgorithm = "SJF";
     } else if (algorithm == "RR") {
         char buffer[10];
-        GetWindowText(hQuantumEdit, buffer, 10);
-        int quantum = atoi(buffer);
-        if (quantum <= 0) quantum = 2;
-
-        auto result = CPUScheduler::roundRobin(processes, quantum);
-        lastResults = result.first;
-        lastGantt = result.second;
-        lastAlgorithm = "Round Robin (q=" + to_string(quantum) + ")";
+        GetWindowText(hAdaptiveEdit, buffer, 10);
+        int percentile = atoi(buffer);
+        if (percentile > 0) {
+            // quantum follows this percentile of the queued remaining bursts
+            vector<QuantumStep> trajectory;
+            auto result = CPUScheduler::adaptiveRoundRobin(processes, min(percentile, 100), trajectory, costModel);
+            lastResults = result.first;
+            lastGantt = result.second;
+            int low = trajectory.empty() ? 0 : trajectory[0].quantum, high = low;
+            for (const auto& step : trajectory) {
+                low = min(low, step.quantum);
+                high = max(high, step.quantum);
+            }
+            lastAlgorithm = "Round Robin (adaptive p" + to_string(min(percentile, 100)) + ", q " + to_string(low) +
+                            "-" + to_string(high) + " over " + to_string(trajectory.size()) + " changes)";
+        } else {
+            GetWindowText(hQuantumEdit, buffer, 10);
+            int quantum = atoi(buffer);
+            if (quantum <= 0) quantum = 2;
+
+            auto result = CPUScheduler::roundRobin(processes, quantum, costModel);
+            lastResults = result.first;
+            lastGantt = result.second;
+            lastAlgorithm = "Round Robin (q=" + to_string(quantum) + ")";
+        }
     } else if (algorithm == "Priority") {
-        auto result = CPUScheduler::priority(processes);
+        auto result = CPUScheduler::priority(processes, costModel);
         lastResults = result.first;
         lastGantt = result.second;
         lastAlgorithm = "Priority";
@@ -379,7 +300,7 @@ void RunAlgorithm(const string& algorithm) {
 void DrawGanttChart(HDC hdc) {
     if (lastGantt.empty()) return;
 
-    int maxTime = 0;
+    long long maxTime = 0;
     for (const auto& entry : lastGantt) {
         maxTime = max(maxTime, entry.endTime);
     }
@@ -405,9 +326,19 @@ void DrawGanttChart(HDC hdc) {
             CreateSolidBrush(RGB(100, 255, 255))   // Cyan
         };
 
+        HBRUSH switchBrush = CreateHatchBrush(HS_BDIAGONAL, RGB(128, 128, 128));
+
         for (const auto& entry : lastGantt) {
-            int x1 = chartX + (entry.startTime * chartWidth) / maxTime;
-            int x2 = chartX + (entry.endTime * chartWidth) / maxTime;
+            int x1 = chartX + (int)((entry.startTime * chartWidth) / maxTime);
+            int x2 = chartX + (int)((entry.endTime * chartWidth) / maxTime);
+
+            if (entry.isSwitch) {
+                // Switch overhead: hatched grey, no label
+                RECT switchRect = {x1, chartY, x2, chartY + chartHeight};
+                FillRect(hdc, &switchRect, switchBrush);
+                FrameRect(hdc, &switchRect, (HBRUSH)GetStockObject(GRAY_BRUSH));
+                continue;
+            }
 
             RECT processRect = {x1, chartY, x2, chartY + chartHeight};
             FillRect(hdc, &processRect, brushes[(entry.processId - 1) % 6]);
@@ -422,8 +353,8 @@ void DrawGanttChart(HDC hdc) {
 
         // Draw time markers
         SetTextColor(hdc, RGB(0, 0, 0));
-        for (int t = 0; t <= maxTime; t += max(1, maxTime / 10)) {
-            int x = chartX + (t * chartWidth) / maxTime;
+        for (long long t = 0; t <= maxTime; t += max(1LL, maxTime / 10)) {
+            int x = chartX + (int)((t * chartWidth) / maxTime);
 
             // Draw tick mark
             MoveToEx(hdc, x, chartY + chartHeight, NULL);
@@ -438,6 +369,7 @@ void DrawGanttChart(HDC hdc) {
         for (int i = 0; i < 6; i++) {
             DeleteObject(brushes[i]);
         }
+        DeleteObject(switchBrush);
 
         // Draw title
         SetTextColor(hdc, RGB(0, 0, 0));
@@ -509,6 +441,27 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
             CreateWindow("STATIC", "Scheduling Algorithms:", WS_VISIBLE | WS_CHILD | SS_LEFT,
                         10, 265, 180, 20, hwnd, NULL, NULL, NULL);
 
+            // Context-switch cost model
+            CreateWindow("STATIC", "Switch Cost:", WS_VISIBLE | WS_CHILD,
+                        200, 265, 80, 20, hwnd, NULL, NULL, NULL);
+            hSwitchCostEdit = CreateWindow("EDIT", "0", WS_VISIBLE | WS_CHILD | WS_BORDER | ES_NUMBER,
+                                         280, 262, 40, 20, hwnd, (HMENU)ID_SWITCH_COST_EDIT, NULL, NULL);
+
+            CreateWindow("STATIC", "Cache Refill:", WS_VISIBLE | WS_CHILD,
+                        340, 265, 80, 20, hwnd, NULL, NULL, NULL);
+            hCacheRefillEdit = CreateWindow("EDIT", "0", WS_VISIBLE | WS_CHILD | WS_BORDER | ES_NUMBER,
+                                          420, 262, 40, 20, hwnd, (HMENU)ID_CACHE_REFILL_EDIT, NULL, NULL);
+
+            CreateWindow("STATIC", "Cold After:", WS_VISIBLE | WS_CHILD,
+                        480, 265, 70, 20, hwnd, NULL, NULL, NULL);
+            hCacheColdEdit = CreateWindow("EDIT", "0", WS_VISIBLE | WS_CHILD | WS_BORDER | ES_NUMBER,
+                                        550, 262, 40, 20, hwnd, (HMENU)ID_CACHE_COLD_EDIT, NULL, NULL);
+
+            CreateWindow("STATIC", "RR Adaptive %:", WS_VISIBLE | WS_CHILD,
+                        600, 265, 95, 20, hwnd, NULL, NULL, NULL);
+            hAdaptiveEdit = CreateWindow("EDIT", "0", WS_VISIBLE | WS_CHILD | WS_BORDER | ES_NUMBER,
+                                       700, 262, 40, 20, hwnd, (HMENU)ID_ADAPTIVE_EDIT, NULL, NULL);
+
             CreateWindow("BUTTON", "FCFS", WS_VISIBLE | WS_CHILD | BS_PUSHBUTTON,
                         10, 290, 80, 30, hwnd, (HMENU)ID_FCFS_BUTTON, NULL, NULL);
 
@@ -534,7 +487,7 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                         10, 335, 100, 20, hwnd, NULL, NULL, NULL);
 
             hResultsList = CreateWindow(WC_LISTVIEW, "", WS_VISIBLE | WS_CHILD | LVS_REPORT | WS_BORDER,
-                                      10, 360, 700, 150, hwnd, (HMENU)ID_RESULTS_LIST, NULL, NULL);
+                                      10, 360, 700, 130, hwnd, (HMENU)ID_RESULTS_LIST, NULL, NULL);
 
             // Add columns to results list
             lvc.cx = 100;
@@ -555,10 +508,13 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
             lvc.cx = 100;
             lvc.pszText = (LPSTR)"Turnaround";
             ListView_InsertColumn(hResultsList, 5, &lvc);
+            lvc.cx = 100;
+            lvc.pszText = (LPSTR)"Response";
+            ListView_InsertColumn(hResultsList, 6, &lvc);
 
             // Metrics display
             hMetricsStatic = CreateWindow("STATIC", "Results will appear here...", WS_VISIBLE | WS_CHILD | SS_LEFT,
-                        10, 520, 700, 20, hwnd, (HMENU)ID_METRICS_STATIC, NULL, NULL);
+                        10, 495, 760, 40, hwnd, (HMENU)ID_METRICS_STATIC, NULL, NULL);
         }
         break;
 
@@ -624,22 +580,35 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                 }
 
                 // Run all algorithms and compare
-                auto fcfsResult = CPUScheduler::fcfs(processes);
-                auto sjfResult = CPUScheduler::sjf(processes);
-                auto rrResult = CPUScheduler::roundRobin(processes, 2);
-                auto priorityResult = CPUScheduler::priority(processes);
+                SwitchCostModel costModel = ReadSwitchCostModel();
+                auto fcfsResult = CPUScheduler::fcfs(processes, costModel);
+                auto sjfResult = CPUScheduler::sjf(processes, costModel);
+                auto rrResult = CPUScheduler::roundRobin(processes, 2, costModel);
+                auto priorityResult = CPUScheduler::priority(processes, costModel);
 
                 double fcfsWait = CPUScheduler::calculateAverageWaitingTime(fcfsResult.first);
                 double sjfWait = CPUScheduler::calculateAverageWaitingTime(sjfResult.first);
                 double rrWait = CPUScheduler::calculateAverageWaitingTime(rrResult.first);
                 double priorityWait = CPUScheduler::calculateAverageWaitingTime(priorityResult.first);
+                long long rrOverhead = CPUScheduler::calculateTotalSwitchOverhead(rrResult.first);
+                // response, max waiting and fairness alongside each average
+                auto details = [](const vector<Process>& results) {
+                    ScheduleMetrics metrics = ScheduleMetrics::of(results);
+                    stringstream text;
+                    text << fixed << setprecision(2) << " (response " << metrics.averageResponse << " ms, max wait "
+                         << metrics.maxWaiting << " ms, fairness " << setprecision(3) << metrics.fairness << ")";
+                    return text.str();
+                };
 
                 stringstream ss;
                 ss << "Algorithm Comparison (Average Waiting Time):\n\n";
-                ss << "FCFS: " << fixed << setprecision(2) << fcfsWait << " ms\n";
-                ss << "SJF: " << fixed << setprecision(2) << sjfWait << " ms\n";
-                ss << "Round Robin (q=2): " << fixed << setprecision(2) << rrWait << " ms\n";
-                ss << "Priority: " << fixed << setprecision(2) << priorityWait << " ms\n\n";
+                ss << "FCFS: " << fixed << setprecision(2) << fcfsWait << " ms" << details(fcfsResult.first) << "\n";
+                ss << "SJF: " << fixed << setprecision(2) << sjfWait << " ms" << details(sjfResult.first) << "\n";
+                ss << "Round Robin (q=2): " << fixed << setprecision(2) << rrWait << " ms" << details(rrResult.first);
+                if (rrOverhead > 0) ss << " (" << rrOverhead << " ms switching)";
+                ss << "\n";
+                ss << "Priority: " << fixed << setprecision(2) << priorityWait << " ms" << details(priorityResult.first)
+                   << "\n\n";
 
                 double minWait = min({fcfsWait, sjfWait, rrWait, priorityWait});
                 if (minWait == fcfsWait) ss << "Best: FCFS";
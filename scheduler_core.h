@@ -0,0 +1,1400 @@
+/**
+ * CPU Scheduling Algorithm Simulator - Scheduling Core
+ *
+ * Header-only engine shared by the console and GUI front ends. The classic
+ * single-CPU algorithms are one event-driven loop, SchedulingEngine,
+ * specialised at compile time on a ready queue (which job runs next) and a
+ * preemption rule (how long it runs), so each algorithm's ordering is
+ * inlined into its own copy of the loop.
+ */
+
+#ifndef SCHEDULER_CORE_H
+#define SCHEDULER_CORE_H
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <memory>
+#include <new>
+#include <chrono>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <ostream>
+#include <utility>
+#include <thread>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <stdexcept>
+#if __cplusplus >= 202002L && defined(__cpp_impl_coroutine)
+#include <coroutine>
+#include <exception>
+#define CPU_SCHED_COROUTINES 1
+#endif
+
+struct Process {
+    int id;
+    int arrivalTime;
+    int burstTime;
+    int priority;
+    int waitingTime;
+    int turnaroundTime;
+    int completionTime;
+    int remainingTime;
+    int deadline;        // relative deadline, 0 = none
+    int period;          // release period, 0 = one-shot job
+    int contextSwitches; // times the CPU switched to this job
+    int switchTime;      // fixed switch cost charged to this job
+    int cacheRefillTime; // cache-refill penalty charged to this job
+    int threads;         // cores the job needs at once (gang size); single-CPU engines ignore it
+    int firstRunTime;    // when the job was first dispatched, -1 = not yet
+
+    Process() : id(0), arrivalTime(0), burstTime(0), priority(0),
+                waitingTime(0), turnaroundTime(0), completionTime(0), remainingTime(0),
+                deadline(0), period(0), contextSwitches(0), switchTime(0), cacheRefillTime(0), threads(1),
+                firstRunTime(-1) {}
+
+    Process(int i, int at, int bt, int p = 0, int dl = 0, int per = 0)
+        : id(i), arrivalTime(at), burstTime(bt), priority(p),
+          waitingTime(0), turnaroundTime(0), completionTime(0), remainingTime(bt),
+          deadline(dl), period(per), contextSwitches(0), switchTime(0), cacheRefillTime(0), threads(1),
+          firstRunTime(-1) {}
+
+    int switchOverhead() const { return switchTime + cacheRefillTime; }
+    int responseTime() const { return firstRunTime < 0 ? 0 : firstRunTime - arrivalTime; }
+    double slowdown() const { return (double)std::max(turnaroundTime, 1) / std::max(burstTime, 1); }
+};
+
+// Schedule-wide metrics of a finished run, from the per-job results. The
+// span runs from the first arrival to the last completion. Throughput is
+// also taken over every window of `window` ms sliding across the span
+// (0 = a tenth of it, or wide enough for four completions on average):
+// the most and fewest completions any window saw.
+// Utilization counts bursts and switch overhead on one CPU; for a run on
+// `cpus` > 1 the records do not say how many cores each job held, so it
+// is left at -1 (the gang and cluster engines report their own). Slowdown is
+// turnaround over burst, and fairness is Jain's index of burst over
+// turnaround, 1 when every job got the same share of its time in service.
+struct ScheduleMetrics {
+    int jobs;
+    long long span;
+    double averageWaiting;
+    double averageTurnaround;
+    double averageResponse;
+    int maxWaiting;
+    double throughput;          // jobs per ms
+    long long window;
+    int peakWindowJobs;
+    int lowWindowJobs;
+    double cpuUtilization;
+    double averageSlowdown;
+    double maxSlowdown;
+    double fairness;
+
+    ScheduleMetrics()
+        : jobs(0), span(0), averageWaiting(0), averageTurnaround(0), averageResponse(0), maxWaiting(0),
+          throughput(0), window(0), peakWindowJobs(0), lowWindowJobs(0), cpuUtilization(0),
+          averageSlowdown(0), maxSlowdown(0), fairness(0) {}
+
+    static ScheduleMetrics of(const std::vector<Process>& processes, int cpus = 1, long long window = 0) {
+        ScheduleMetrics m;
+        int n = processes.size();
+        if (n == 0) return m;
+        long long first = processes[0].arrivalTime, last = processes[0].completionTime, busy = 0;
+        double share = 0, shareSquares = 0;
+        std::vector<long long> done(n);
+        for (int i = 0; i < n; i++) {
+            const Process& p = processes[i];
+            first = std::min<long long>(first, p.arrivalTime);
+            last = std::max<long long>(last, p.completionTime);
+            busy += p.burstTime + p.switchOverhead();
+            m.averageWaiting += p.waitingTime;
+            m.averageTurnaround += p.turnaroundTime;
+            m.averageResponse += p.responseTime();
+            m.maxWaiting = std::max(m.maxWaiting, p.waitingTime);
+            double slowdown = p.slowdown();
+            m.averageSlowdown += slowdown;
+            m.maxSlowdown = std::max(m.maxSlowdown, slowdown);
+            share += 1 / slowdown;
+            shareSquares += 1 / (slowdown * slowdown);
+            done[i] = p.completionTime;
+        }
+        m.jobs = n;
+        m.span = last - first;
+        m.averageWaiting /= n;
+        m.averageTurnaround /= n;
+        m.averageResponse /= n;
+        m.averageSlowdown /= n;
+        m.fairness = share * share / (n * shareSquares);
+        m.throughput = m.span == 0 ? 0.0 : (double)n / m.span;
+        if (cpus > 1) m.cpuUtilization = -1;
+        else m.cpuUtilization = m.span == 0 ? 0.0 : std::min(1.0, (double)busy / m.span);
+
+        // completions in (t, t + window]: the most end at some completion,
+        // the fewest start at the span's start or just after a completion
+        m.window = window > 0 ? window : std::max(1LL, std::min(m.span, std::max(m.span / 10, 4 * m.span / n)));
+        std::sort(done.begin(), done.end());
+        if (m.span <= m.window) {
+            m.peakWindowJobs = m.lowWindowJobs = n;
+            return m;
+        }
+        for (int i = 0, begin = 0; i < n; i++) {
+            while (done[begin] <= done[i] - m.window) begin++;
+            m.peakWindowJobs = std::max(m.peakWindowJobs, i - begin + 1);
+        }
+        m.lowWindowJobs = n;
+        int from = 0, to = 0;   // completions <= t and <= t + window
+        for (int k = -1; k < n; k++) {
+            long long t = k < 0 ? first : done[k];
+            if (t > last - m.window) break;
+            while (from < n && done[from] <= t) from++;
+            while (to < n && done[to] <= t + m.window) to++;
+            m.lowWindowJobs = std::min(m.lowWindowJobs, to - from);
+        }
+        return m;
+    }
+};
+
+// Overhead of switching the CPU to a different job: a fixed cost plus a
+// cache-refill penalty that grows linearly with how long the job was off
+// the CPU, saturating at maxCacheRefill once it is fully cold. A job that
+// has never run starts cold. All zero (the default) means free switches.
+struct SwitchCostModel {
+    int switchCost;
+    int maxCacheRefill;
+    int cacheColdTime;   // time off-CPU until the cache is fully cold, 0 = always cold
+
+    SwitchCostModel(int cost = 0, int maxRefill = 0, int coldTime = 0)
+        : switchCost(cost), maxCacheRefill(maxRefill), cacheColdTime(coldTime) {}
+
+    int cacheRefill(long long timeAway) const {
+        if (timeAway < 0 || cacheColdTime <= 0 || timeAway >= cacheColdTime) return maxCacheRefill;
+        return (int)(timeAway * maxCacheRefill / cacheColdTime);
+    }
+};
+
+// Bump allocator over blocks that are never freed, only rewound to a mark,
+// so releasing a run's scratch is O(1) and the next run reuses the blocks.
+// Only for trivially destructible data.
+class Arena {
+public:
+    struct Mark {
+        size_t block;
+        size_t offset;
+    };
+
+    static const size_t MIN_BLOCK = 64 * 1024;
+    static const size_t ALIGN = 16;
+
+    Arena() : block(0), offset(0) {}
+
+    void* allocate(size_t bytes) {
+        bytes = (bytes + ALIGN - 1) & ~(ALIGN - 1);
+        while (block < blocks.size() && offset + bytes > sizes[block]) {
+            block++;
+            offset = 0;
+        }
+        if (block == blocks.size()) {
+            size_t size = std::max(bytes, blocks.empty() ? MIN_BLOCK : sizes.back() * 2);
+            blocks.push_back(std::unique_ptr<char[]>(new char[size]));
+            sizes.push_back(size);
+            offset = 0;
+        }
+        void* memory = blocks[block].get() + offset;
+        offset += bytes;
+        return memory;
+    }
+
+    Mark mark() const {
+        Mark m = {block, offset};
+        return m;
+    }
+
+    void rewind(const Mark& m) {
+        block = m.block;
+        offset = m.offset;
+    }
+
+    size_t blockCount() const { return blocks.size(); }
+
+private:
+    std::vector<std::unique_ptr<char[]>> blocks;
+    std::vector<size_t> sizes;
+    size_t block;
+    size_t offset;
+};
+
+// Per-thread scratch memory for the engines. An engine opens a Scope, takes
+// its working arrays from the arena and gives them all back when the Scope
+// ends, so once the blocks have grown to fit, runs allocate nothing.
+class SimulationContext {
+public:
+    static SimulationContext& current() {
+        static thread_local SimulationContext context;
+        return context;
+    }
+
+    class Scope {
+    public:
+        Scope() : context(current()), start(context.arena.mark()) {}
+        ~Scope() { context.arena.rewind(start); }
+    private:
+        SimulationContext& context;
+        Arena::Mark start;
+    };
+
+    template <typename T>
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena.allocate(std::max<size_t>(n, 1) * sizeof(T)));
+    }
+
+    template <typename T>
+    T* allocate(size_t n, const T& value) {
+        T* items = allocate<T>(n);
+        std::fill(items, items + n, value);
+        return items;
+    }
+
+    // blocks obtained from the heap so far; flat across runs = steady state
+    size_t heapBlocks() const { return arena.blockCount(); }
+
+private:
+    Arena arena;
+};
+
+struct GanttEntry {
+    int processId;
+    long long startTime;
+    long long endTime;
+    bool isSwitch;   // context-switch / cache-refill overhead before processId runs
+    int core;
+
+    GanttEntry(int pid, long long start, long long end, bool switching = false, int cpu = 0)
+        : processId(pid), startTime(start), endTime(end), isSwitch(switching), core(cpu) {}
+};
+
+// Receives every slice an engine executes, in time order per run. Engines
+// report through SwitchTracker to whichever sink is active on their thread.
+class SliceSink {
+public:
+    virtual ~SliceSink() {}
+    virtual void beginRun(const char* engine) = 0;
+    virtual void slice(const GanttEntry& entry) = 0;
+
+    static SliceSink*& active() {
+        static thread_local SliceSink* sink = 0;
+        return sink;
+    }
+};
+
+// Tracks which job last held the CPU and when each job was descheduled,
+// charging SwitchCostModel overhead whenever a different job is dispatched.
+// A job's first dispatch sets its firstRunTime. Dispatch-to-stop intervals
+// are the executed slices, so they are also forwarded to the active
+// SliceSink, if any.
+class SwitchTracker {
+public:
+    // lastStop lives in the caller's SimulationContext scope
+    SwitchTracker(const SwitchCostModel& model, int n, const char* engine = "")
+        : model(model), lastStop(SimulationContext::current().allocate<long long>(n, -1)), jobs(n),
+          lastIdx(-1), sink(SliceSink::active()), runId(0), runStart(0) {
+        if (sink) sink->beginRun(engine);
+    }
+
+    // Returns the overhead to spend before processes[idx] runs from now.
+    int dispatch(Process& process, int idx, long long now) {
+        int overhead = 0;
+        if (process.firstRunTime < 0) process.firstRunTime = (int)now;
+        if (idx != lastIdx) {
+            lastIdx = idx;
+            int refill = model.cacheRefill(lastStop[idx] < 0 ? -1 : now - lastStop[idx]);
+            process.contextSwitches++;
+            process.switchTime += model.switchCost;
+            process.cacheRefillTime += refill;
+            overhead = model.switchCost + refill;
+        }
+        if (sink) {
+            if (overhead > 0) sink->slice(GanttEntry(process.id, now, now + overhead, true));
+            runId = process.id;
+            runStart = now + overhead;
+        }
+        return overhead;
+    }
+
+    void stop(int idx, long long now) {
+        lastStop[idx] = now;
+        if (sink && now > runStart) sink->slice(GanttEntry(runId, runStart, now));
+    }
+
+    // Archive is the console's checkpoint Snapshot
+    template <typename Archive>
+    void save(Archive& snapshot) const {
+        snapshot.putVector(std::vector<long long>(lastStop, lastStop + jobs));
+        snapshot.put(lastIdx);
+    }
+
+    template <typename Archive>
+    bool load(Archive& snapshot) {
+        std::vector<long long> stops;
+        if (!snapshot.getVector(stops) || (int)stops.size() != jobs || !snapshot.get(lastIdx)) return false;
+        std::copy(stops.begin(), stops.end(), lastStop);
+        return true;
+    }
+
+private:
+    SwitchCostModel model;
+    long long* lastStop;
+    int jobs;
+    int lastIdx;
+    SliceSink* sink;
+    int runId;
+    long long runStart;
+};
+
+#ifndef ENGINE_COUNTERS
+#define ENGINE_COUNTERS 0
+#endif
+
+// Hot-path instrumentation, compiled in with -DENGINE_COUNTERS=1. Each
+// engine opens a Run (nested runs fold into the outer one) and times its
+// phases; finished runs queue up as JSON objects until dump(). Counters are
+// per thread. The disabled specialisation is all empty inlines.
+template <bool Enabled>
+class BasicEngineCounters {
+public:
+    static const bool enabled = true;
+    static const int MAX_PHASES = 8;
+
+    long long pushes, pops, comparisons, idleTicks, arrivalScans, slices, bytesAllocated;
+
+    static BasicEngineCounters& current() {
+        static thread_local BasicEngineCounters counters;
+        return counters;
+    }
+
+    class Run {
+    public:
+        explicit Run(const char* engine) : counters(current()) { counters.open(engine); }
+        ~Run() { counters.close(); }
+    private:
+        BasicEngineCounters& counters;
+    };
+
+    // Times from construction (or next()) until the next next() or scope end.
+    class Phase {
+    public:
+        explicit Phase(const char* name)
+            : counters(current()), name(name), start(std::chrono::steady_clock::now()) {}
+        ~Phase() { counters.phaseDone(name, start); }
+        void next(const char* nextName) {
+            counters.phaseDone(name, start);
+            name = nextName;
+            start = std::chrono::steady_clock::now();
+        }
+    private:
+        BasicEngineCounters& counters;
+        const char* name;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    void push(long long k = 1) { pushes += k; }
+    void pop(long long k = 1) { pops += k; }
+    void compare(long long k = 1) { comparisons += k; }
+    void idleTick(long long k = 1) { idleTicks += k; }
+    void arrivalScan(long long k = 1) { arrivalScans += k; }
+    void slice(long long k = 1) { slices += k; }
+    void allocated(size_t bytes) { if (depth > 0) bytesAllocated += bytes; }
+    long long allocatedBytes() const { return bytesAllocated; }   // current or last run
+
+    void dump(std::ostream& out) {
+        if (log.empty()) return;
+        out << "Engine counters: [" << log << "]\n";
+        log.clear();
+    }
+
+private:
+    BasicEngineCounters() : depth(0), engine(""), phaseCount(0) { clear(); }
+
+    int depth;
+    const char* engine;
+    std::chrono::steady_clock::time_point runStart;
+    std::pair<const char*, double> phases[MAX_PHASES];   // fixed, so timing never allocates
+    int phaseCount;
+    std::string log;
+
+    void clear() {
+        pushes = pops = comparisons = idleTicks = arrivalScans = slices = bytesAllocated = 0;
+        phaseCount = 0;
+    }
+
+    void open(const char* name) {
+        if (depth++ > 0) return;
+        engine = name;
+        clear();
+        runStart = std::chrono::steady_clock::now();
+    }
+
+    void phaseDone(const char* name, std::chrono::steady_clock::time_point start) {
+        if (depth == 0) return;
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        for (int k = 0; k < phaseCount; k++) {
+            if (std::string(phases[k].first) == name) {
+                phases[k].second += ms;
+                return;
+            }
+        }
+        if (phaseCount < MAX_PHASES) phases[phaseCount++] = std::make_pair(name, ms);
+    }
+
+    void close() {
+        if (--depth > 0) return;
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - runStart).count();
+        std::ostringstream json;
+        json << std::fixed << std::setprecision(3)
+             << "{\"engine\": \"" << engine << "\", \"pushes\": " << pushes << ", \"pops\": " << pops
+             << ", \"comparisons\": " << comparisons << ", \"idleTicks\": " << idleTicks
+             << ", \"arrivalScans\": " << arrivalScans << ", \"slices\": " << slices
+             << ", \"bytesAllocated\": " << bytesAllocated << ", \"totalMs\": " << ms << ", \"phasesMs\": {";
+        for (int k = 0; k < phaseCount; k++) {
+            json << (k ? ", " : "") << "\"" << phases[k].first << "\": " << phases[k].second;
+        }
+        json << "}}";
+        if (!log.empty()) log += ", ";
+        log += json.str();
+    }
+};
+
+template <>
+class BasicEngineCounters<false> {
+public:
+    static const bool enabled = false;
+
+    static BasicEngineCounters& current() {
+        static BasicEngineCounters counters;
+        return counters;
+    }
+
+    struct Run {
+        explicit Run(const char*) {}
+    };
+
+    struct Phase {
+        explicit Phase(const char*) {}
+        void next(const char*) {}
+    };
+
+    void push(long long = 1) {}
+    void pop(long long = 1) {}
+    void compare(long long = 1) {}
+    void idleTick(long long = 1) {}
+    void arrivalScan(long long = 1) {}
+    void slice(long long = 1) {}
+    void allocated(size_t) {}
+    long long allocatedBytes() const { return 0; }
+    void dump(std::ostream&) {}
+};
+
+typedef BasicEngineCounters<ENGINE_COUNTERS != 0> EngineCounters;
+
+// Stable LSD radix sort producing an index permutation: order[k] is the
+// index of the k-th smallest key, equal keys in index order. Keys are
+// unsigned 32- or 64-bit, sorted a byte per pass, skipping bytes every key
+// shares. From PARALLEL_MIN keys each thread counts and scatters its own
+// slice per pass, which keeps the sort stable. Scratch comes from the
+// caller's SimulationContext scope.
+class RadixSort {
+public:
+    static const int PARALLEL_MIN = 1 << 20;
+    static const int MIN_SLICE = 1 << 18;   // keys per thread below which threads cost more than they save
+
+    template <typename Key>
+    static void sortIndices(const Key* keys, int n, int* order, int threads = 0) {
+        SimulationContext& context = SimulationContext::current();
+        Key* keyFrom = context.allocate<Key>(n);
+        Key* keyTo = context.allocate<Key>(n);
+        int* indexFrom = order;
+        int* indexTo = context.allocate<int>(n);
+        std::copy(keys, keys + n, keyFrom);
+        std::iota(order, order + n, 0);
+
+        int slices = 1;
+        if (n >= PARALLEL_MIN) {
+            if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+            slices = std::max(1, std::min(threads, n / MIN_SLICE));
+        }
+        int* counts = context.allocate<int>(slices * 256);
+
+        for (unsigned shift = 0; shift < 8 * sizeof(Key); shift += 8) {
+            forEachSlice(n, slices, [&](int s, int begin, int end) {
+                int* count = counts + s * 256;
+                std::fill(count, count + 256, 0);
+                for (int i = begin; i < end; i++) count[(keyFrom[i] >> shift) & 0xFF]++;
+            });
+            bool shared = false;
+            for (int digit = 0; digit < 256 && !shared; digit++) {
+                int total = 0;
+                for (int s = 0; s < slices; s++) total += counts[s * 256 + digit];
+                shared = total == n;
+            }
+            if (shared) continue;
+
+            int offset = 0;   // slice s writes digit d after every earlier digit and slice
+            for (int digit = 0; digit < 256; digit++) {
+                for (int s = 0; s < slices; s++) {
+                    int count = counts[s * 256 + digit];
+                    counts[s * 256 + digit] = offset;
+                    offset += count;
+                }
+            }
+            forEachSlice(n, slices, [&](int s, int begin, int end) {
+                int* next = counts + s * 256;
+                for (int i = begin; i < end; i++) {
+                    int pos = next[(keyFrom[i] >> shift) & 0xFF]++;
+                    keyTo[pos] = keyFrom[i];
+                    indexTo[pos] = indexFrom[i];
+                }
+            });
+            std::swap(keyFrom, keyTo);
+            std::swap(indexFrom, indexTo);
+        }
+        if (indexFrom != order) std::copy(indexFrom, indexFrom + n, order);
+    }
+
+private:
+    // fn(slice, begin, end) over `slices` contiguous parts of [0, n), the
+    // first on the calling thread
+    template <typename Fn>
+    static void forEachSlice(int n, int slices, Fn fn) {
+        if (slices == 1) {
+            fn(0, 0, n);
+            return;
+        }
+        std::vector<std::thread> workers;
+        for (int s = 1; s < slices; s++) {
+            workers.push_back(std::thread(fn, s, (int)((long long)n * s / slices),
+                                          (int)((long long)n * (s + 1) / slices)));
+        }
+        fn(0, 0, (int)((long long)n / slices));
+        for (auto& worker : workers) worker.join();
+    }
+};
+
+// Below this the radix passes' fixed cost (256-entry counts) loses to a
+// merge sort; measured crossover is around 200 jobs.
+static const int RADIX_SORT_MIN = 256;
+
+// Indices in stable arrival order, allocated in the caller's
+// SimulationContext scope. Radix sorted from RADIX_SORT_MIN jobs,
+// bottom-up merge sorted below.
+inline const int* sortedByArrival(const std::vector<Process>& processes, int threads = 0) {
+    SimulationContext& context = SimulationContext::current();
+    int n = processes.size();
+    int* order = context.allocate<int>(n);
+    std::iota(order, order + n, 0);
+    auto earlier = [&](int a, int b) {
+        return processes[a].arrivalTime < processes[b].arrivalTime;
+    };
+    if (std::is_sorted(order, order + n, earlier)) return order;
+
+    if (n >= RADIX_SORT_MIN) {
+        SimulationContext::Scope keyScratch;   // order was allocated before, so it survives
+        uint32_t* keys = context.allocate<uint32_t>(n);
+        for (int i = 0; i < n; i++) keys[i] = (uint32_t)processes[i].arrivalTime ^ 0x80000000u;
+        RadixSort::sortIndices(keys, n, order, threads);
+        return order;
+    }
+
+    int* merged = context.allocate<int>(n);
+    for (int width = 1; width < n; width *= 2) {
+        for (int lo = 0; lo < n; lo += 2 * width) {
+            int mid = std::min(lo + width, n), hi = std::min(lo + 2 * width, n);
+            std::merge(order + lo, order + mid, order + mid, order + hi, merged + lo, earlier);
+        }
+        std::swap(order, merged);
+    }
+    return order;
+}
+
+// Ready queues: constructed for n jobs inside the engine's SimulationContext
+// scope (or from an arena the owner keeps, for long-lived engines), then
+// push(job, process) / pop() / empty(). A job is queued at most once at a
+// time, so n slots always suffice.
+
+// FIFO of job indices, for FCFS and round robin.
+class FifoQueue {
+public:
+    explicit FifoQueue(int n)
+        : slots(SimulationContext::current().allocate<int>(n)), capacity(std::max(n, 1)), head(0), count(0) {}
+    FifoQueue(int n, Arena& arena)
+        : slots(static_cast<int*>(arena.allocate(std::max(n, 1) * sizeof(int)))), capacity(std::max(n, 1)),
+          head(0), count(0) {}
+
+    void push(int job, const Process&, int = 0) {
+        slots[(head + count++) % capacity] = job;
+    }
+    int pop() {
+        int job = slots[head];
+        head = (head + 1) % capacity;
+        count--;
+        return job;
+    }
+    bool empty() const { return count == 0; }
+
+private:
+    int* slots;
+    int capacity;
+    int head;
+    int count;
+};
+
+// Binary min-heap on Key::of(process), ties to the lower job index or to
+// the lower `order` the caller supplies instead.
+template <typename Key>
+class KeyedQueue {
+public:
+    explicit KeyedQueue(int n) : heap(SimulationContext::current().allocate<Entry>(n)), count(0) {}
+    KeyedQueue(int n, Arena& arena)
+        : heap(static_cast<Entry*>(arena.allocate(std::max(n, 1) * sizeof(Entry)))), count(0) {}
+
+    void push(int job, const Process& process) { push(job, process, job); }
+    void push(int job, const Process& process, int order) {
+        Entry entry = {Key::of(process), order, job};
+        heap[count++] = entry;
+        std::push_heap(heap, heap + count, later);
+    }
+    int pop() {
+        std::pop_heap(heap, heap + count, later);
+        return heap[--count].job;
+    }
+    bool empty() const { return count == 0; }
+
+private:
+    struct Entry {
+        long long key;
+        int order;
+        int job;
+    };
+
+    static bool later(const Entry& a, const Entry& b) {
+        EngineCounters::current().compare();
+        return a.key != b.key ? a.key > b.key : a.order > b.order;
+    }
+
+    Entry* heap;
+    int count;
+};
+
+// Min-queue on Key::of(process) whose equal keys leave in push order: a
+// binary heap of the distinct keys queued, each with a FIFO of its jobs,
+// found through an open-addressing table. Pushing onto or popping from a
+// key already queued is O(1); only a new or emptied key pays O(log keys).
+// The `order` argument is ignored, so this pops as KeyedQueue does for
+// callers whose order rises with every push.
+template <typename Key>
+class BucketQueue {
+public:
+    explicit BucketQueue(int n) {
+        SimulationContext& context = SimulationContext::current();
+        init(n, [&](size_t bytes) { return static_cast<void*>(context.allocate<char>(bytes)); });
+    }
+    BucketQueue(int n, Arena& arena) {
+        init(n, [&](size_t bytes) { return arena.allocate(bytes); });
+    }
+
+    void push(int job, const Process& process, int = 0) {
+        long long key = Key::of(process);
+        next[job] = -1;
+        int slot = find(key);
+        int bucket = slots[slot];
+        if (bucket >= 0) {
+            next[buckets[bucket].tail] = job;
+            buckets[bucket].tail = job;
+            return;
+        }
+        bucket = freeBuckets[--freeCount];
+        buckets[bucket].key = key;
+        buckets[bucket].head = buckets[bucket].tail = job;
+        slots[slot] = bucket;
+        heap[heapSize++] = bucket;
+        std::push_heap(heap, heap + heapSize, Later(buckets));
+    }
+    int pop() {
+        Bucket& bucket = buckets[heap[0]];
+        int job = bucket.head;
+        bucket.head = next[job];
+        if (bucket.head < 0) {
+            erase(find(bucket.key));
+            freeBuckets[freeCount++] = heap[0];
+            std::pop_heap(heap, heap + heapSize, Later(buckets));
+            heapSize--;
+        }
+        return job;
+    }
+    bool empty() const { return heapSize == 0; }
+
+private:
+    struct Bucket {
+        long long key;
+        int head;
+        int tail;
+    };
+
+    struct Later {
+        const Bucket* buckets;
+        explicit Later(const Bucket* buckets) : buckets(buckets) {}
+        bool operator()(int a, int b) const {
+            EngineCounters::current().compare();
+            return buckets[a].key > buckets[b].key;
+        }
+    };
+
+    template <typename Allocate>
+    void init(int n, Allocate allocate) {
+        n = std::max(n, 1);
+        int size = 2;
+        while (size < 2 * n) size *= 2;   // load factor at most 1/2
+        mask = size - 1;
+        next = static_cast<int*>(allocate(n * sizeof(int)));
+        buckets = static_cast<Bucket*>(allocate(n * sizeof(Bucket)));
+        heap = static_cast<int*>(allocate(n * sizeof(int)));
+        freeBuckets = static_cast<int*>(allocate(n * sizeof(int)));
+        slots = static_cast<int*>(allocate(size * sizeof(int)));
+        std::fill(slots, slots + size, -1);
+        for (int k = 0; k < n; k++) freeBuckets[k] = n - 1 - k;
+        freeCount = n;
+        heapSize = 0;
+    }
+
+    int home(long long key) const {
+        return (int)(((unsigned long long)key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+    }
+
+    // the key's slot, or the empty slot where it would go
+    int find(long long key) const {
+        int slot = home(key);
+        while (slots[slot] >= 0 && buckets[slots[slot]].key != key) slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    // linear-probing delete: pull later entries of the probe run back over the gap
+    void erase(int slot) {
+        for (int probe = (slot + 1) & mask; slots[probe] >= 0; probe = (probe + 1) & mask) {
+            int wanted = home(buckets[slots[probe]].key);
+            bool stays = slot <= probe ? slot < wanted && wanted <= probe : slot < wanted || wanted <= probe;
+            if (stays) continue;
+            slots[slot] = slots[probe];
+            slot = probe;
+        }
+        slots[slot] = -1;
+    }
+
+    int* next;          // by job: the job queued after it under the same key
+    Bucket* buckets;
+    int* heap;          // buckets with jobs, by key
+    int* freeBuckets;
+    int* slots;         // key -> bucket, -1 = empty
+    int mask;
+    int freeCount;
+    int heapSize;
+};
+
+struct ShortestBurst {
+    static long long of(const Process& process) { return process.burstTime; }
+};
+
+struct HighestPriority {   // lower number = higher priority
+    static long long of(const Process& process) { return process.priority; }
+};
+
+// Preemption rules: slice(remaining) is how long a dispatched job runs.
+// SchedulingEngine runs its own copy of the rule and also reports each job
+// it queues (queued) and each job it takes off the queue, before the
+// switch (dispatching), so a rule may keep state about the ready queue.
+struct RunToCompletion {
+    void queued(const Process&) {}
+    void dispatching(const Process&, long long) {}
+    int slice(int remaining) const { return remaining; }
+};
+
+struct QuantumExpiry {
+    int quantum;
+
+    explicit QuantumExpiry(int q) : quantum(q) {}
+    void queued(const Process&) {}
+    void dispatching(const Process&, long long) {}
+    int slice(int remaining) const { return std::min(quantum, remaining); }
+};
+
+// Single-CPU event-driven engine. Arrivals are released in arrival order;
+// jobs arriving by the same moment queue in input order, and a preempted
+// job requeues behind them. With an empty queue the clock jumps to the next
+// arrival. Fills in the timing fields of `processes` in place.
+template <typename ReadyQueue, typename Preemption>
+class SchedulingEngine {
+public:
+    static void run(std::vector<Process>& processes, const Preemption& rule,
+                    const SwitchCostModel& costModel, const char* engine) {
+        EngineCounters& counters = EngineCounters::current();
+        SimulationContext::Scope scratch;
+        EngineCounters::Phase phase("sort");
+        int n = processes.size();
+        const int* order = sortedByArrival(processes);
+        phase.next("simulate");
+
+        Preemption preemption(rule);
+
+        ReadyQueue ready(n);
+        int* arrived = SimulationContext::current().allocate<int>(n);
+        SwitchTracker switches(costModel, n, engine);
+        for (auto& process : processes) {
+            process.remainingTime = process.burstTime;
+        }
+
+        int nextArrival = 0, completed = 0;
+        long long currentTime = 0;
+        auto release = [&]() {
+            int count = 0;
+            while (nextArrival < n && processes[order[nextArrival]].arrivalTime <= currentTime) {
+                arrived[count++] = order[nextArrival++];
+            }
+            counters.arrivalScan(count);
+            std::sort(arrived, arrived + count);
+            for (int k = 0; k < count; k++) {
+                counters.push();
+                ready.push(arrived[k], processes[arrived[k]]);
+                preemption.queued(processes[arrived[k]]);
+            }
+        };
+
+        release();
+        while (completed < n) {
+            if (ready.empty()) {
+                long long next = processes[order[nextArrival]].arrivalTime;
+                counters.idleTick(next - currentTime);
+                currentTime = next;
+                release();
+                continue;
+            }
+
+            int idx = ready.pop();
+            counters.pop();
+            counters.slice();
+            Process& process = processes[idx];
+            preemption.dispatching(process, currentTime);
+            currentTime += switches.dispatch(process, idx, currentTime);
+            int execTime = preemption.slice(process.remainingTime);
+            currentTime += execTime;
+            process.remainingTime -= execTime;
+            switches.stop(idx, currentTime);
+            release();
+
+            if (process.remainingTime == 0) {
+                process.completionTime = (int)currentTime;
+                process.turnaroundTime = process.completionTime - process.arrivalTime;
+                process.waitingTime = process.turnaroundTime - process.burstTime - process.switchOverhead();
+                completed++;
+            } else {
+                counters.push();
+                ready.push(idx, process);
+                preemption.queued(process);
+            }
+        }
+    }
+};
+
+typedef SchedulingEngine<FifoQueue, RunToCompletion> FcfsEngine;   // input pre-sorted by arrival
+typedef SchedulingEngine<KeyedQueue<ShortestBurst>, RunToCompletion> SjfEngine;
+typedef SchedulingEngine<FifoQueue, QuantumExpiry> RoundRobinEngine;
+typedef SchedulingEngine<KeyedQueue<HighestPriority>, RunToCompletion> PriorityEngine;
+
+
+// Multiset of non-negative ints with rank queries: a Fenwick tree of counts
+// over the value range, O(log range) per insert, erase and k-th smallest.
+// Ranges beyond MAX_SLOTS share slots of 2^shift values, and kth() then
+// answers with its slot's upper end.
+class OrderStatistic {
+public:
+    static const int MAX_SLOTS = 1 << 20;
+
+    explicit OrderStatistic(int maxValue) : shift(0), total(0), maxValue(std::max(maxValue, 0)) {
+        while ((this->maxValue >> shift) >= MAX_SLOTS) shift++;
+        slots = (this->maxValue >> shift) + 1;
+        top = 1;
+        while (top * 2 <= slots) top *= 2;
+        tree = SimulationContext::current().allocate<int>(slots + 1, 0);
+    }
+
+    void insert(int value) { add(value, 1); }
+    void erase(int value) { add(value, -1); }
+    int size() const { return total; }
+
+    // k-th smallest, 1-based; k must be in [1, size()]
+    int kth(int k) const {
+        int position = 0;
+        for (int step = top; step > 0; step /= 2) {
+            if (position + step <= slots && tree[position + step] < k) {
+                position += step;
+                k -= tree[position];
+            }
+        }
+        // the answer is in slot `position` (0-based)
+        return std::min(maxValue, ((position + 1) << shift) - 1);
+    }
+
+private:
+    int shift;
+    int total;
+    int maxValue;
+    int slots;
+    int top;
+    int* tree;
+
+    void add(int value, int delta) {
+        total += delta;
+        for (int i = (value >> shift) + 1; i <= slots; i += i & -i) tree[i] += delta;
+    }
+};
+
+// Quantum in force from `time` on, with `queued` jobs ready when it was set.
+struct QuantumStep {
+    long long time;
+    int quantum;
+    int queued;
+};
+
+// Round robin whose quantum follows the ready queue. At the start of each
+// round (once every job that was queued when the previous round started
+// has had a slice) the quantum becomes the given percentile of the queued
+// jobs' remaining times, 50 = median, at least 1. The remaining times live
+// in an OrderStatistic, so a recomputation is O(log max burst). Jobs
+// arriving mid-round use the current quantum. Each change of quantum is
+// appended to `trajectory`, if given. Copies share the OrderStatistic, so
+// only the engine's copy is used once a run starts.
+class AdaptiveQuantum {
+public:
+    AdaptiveQuantum(int maxBurst, double percentile, std::vector<QuantumStep>* trajectory = 0)
+        : remaining(maxBurst), fraction(std::min(100.0, std::max(0.0, percentile)) / 100.0),
+          trajectory(trajectory), roundLeft(0), quantum(0) {}
+
+    void queued(const Process& process) { remaining.insert(process.remainingTime); }
+
+    void dispatching(const Process& process, long long now) {
+        if (roundLeft == 0) {
+            int queued = remaining.size();
+            int rank = std::max(1, (int)std::ceil(fraction * queued));
+            int next = std::max(1, remaining.kth(rank));
+            if (next != quantum && trajectory) {
+                QuantumStep step = {now, next, queued};
+                trajectory->push_back(step);
+            }
+            quantum = next;
+            roundLeft = queued;
+        }
+        roundLeft--;
+        remaining.erase(process.remainingTime);
+    }
+
+    int slice(int remainingTime) const { return std::min(quantum, remainingTime); }
+
+private:
+    OrderStatistic remaining;
+    double fraction;
+    std::vector<QuantumStep>* trajectory;
+    int roundLeft;
+    int quantum;
+};
+
+class AdaptiveRoundRobinEngine {
+public:
+    static void run(std::vector<Process>& processes, double percentile, const SwitchCostModel& costModel,
+                    std::vector<QuantumStep>* trajectory = 0) {
+        SimulationContext::Scope scratch;   // holds the rule's OrderStatistic
+        int maxBurst = 0;
+        for (const auto& process : processes) maxBurst = std::max(maxBurst, process.burstTime);
+        SchedulingEngine<FifoQueue, AdaptiveQuantum>::run(processes, AdaptiveQuantum(maxBurst, percentile, trajectory),
+                                                          costModel, "Adaptive Round Robin");
+    }
+};
+
+// Running totals of an online engine, updated as jobs complete.
+struct OnlineMetrics {
+    long long submitted;
+    long long completed;
+    long long totalWaiting;
+    long long totalTurnaround;
+    long long totalResponse;
+    long long maxWaiting;
+    long long busyTime;         // dispatched time, switch overhead included
+    long long firstSubmit;
+    long long lastEvent;
+
+    OnlineMetrics()
+        : submitted(0), completed(0), totalWaiting(0), totalTurnaround(0), totalResponse(0), maxWaiting(0), busyTime(0),
+          firstSubmit(-1), lastEvent(0) {}
+
+    double averageWaiting() const { return completed == 0 ? 0.0 : (double)totalWaiting / completed; }
+    double averageTurnaround() const { return completed == 0 ? 0.0 : (double)totalTurnaround / completed; }
+    double averageResponse() const { return completed == 0 ? 0.0 : (double)totalResponse / completed; }
+    long long elapsed() const { return firstSubmit < 0 ? 0 : lastEvent - firstSubmit; }
+    double throughput() const { return elapsed() == 0 ? 0.0 : (double)completed / elapsed(); }
+    double utilization() const { return elapsed() == 0 ? 0.0 : std::min(1.0, (double)busyTime / elapsed()); }
+};
+
+// The engines' policies for jobs that arrive while the CPU runs, for a
+// caller that owns the clock. submit() queues a job as of its arrivalTime
+// and returns its handle (-1 when all `capacity` slots are in use).
+// next(now) is called whenever the CPU is free or the running job's slice
+// ends; an unfinished running job is requeued behind the jobs submitted so
+// far, and the returned Dispatch says what to run and for how long.
+// complete(handle, now) reports that the running job finished; any other
+// handle throws logic_error and changes nothing, since a queued handle
+// returned to the free list would be queued twice. The preemption rule
+// sees every queued job and dispatch through its queued() and
+// dispatching() hooks, as in SchedulingEngine, so stateful rules such as
+// AdaptiveQuantum work online too. Each call is O(log capacity) at most
+// and allocates nothing; all storage is sized in the constructor. Equal
+// keys go to the earlier submission (the counter wraps after 2^31). Fed
+// the same arrivals in input order at the same decision points, the
+// schedule matches SchedulingEngine's.
+template <typename ReadyQueue, typename Preemption>
+class OnlineEngine {
+public:
+    struct Dispatch {
+        int job;        // handle, -1 = nothing ready
+        int overhead;   // switch and cache-refill time before it runs
+        int slice;      // then run this long, or until it completes
+    };
+
+    explicit OnlineEngine(int capacity, const Preemption& preemption = Preemption(),
+                          const SwitchCostModel& costModel = SwitchCostModel())
+        : capacity(std::max(capacity, 1)), ready(this->capacity, arena), preemption(preemption), costModel(costModel),
+          jobs(this->capacity), readySince(this->capacity), lastStop(this->capacity), sequence(this->capacity),
+          freeSlots(this->capacity),
+          freeCount(this->capacity), running(-1), lastJob(-1), sliceStart(0), sliceEnd(0) {
+        for (int k = 0; k < this->capacity; k++) freeSlots[k] = this->capacity - 1 - k;
+    }
+
+    int submit(const Process& job) {
+        if (freeCount == 0) return -1;
+        int handle = freeSlots[--freeCount];
+        Process& process = jobs[handle];
+        process = job;
+        process.remainingTime = process.burstTime;
+        process.waitingTime = process.contextSwitches = process.switchTime = process.cacheRefillTime = 0;
+        process.firstRunTime = -1;
+        readySince[handle] = job.arrivalTime;
+        lastStop[handle] = -1;
+        sequence[handle] = (int)(stats.submitted & 0x7fffffff);
+        ready.push(handle, process, sequence[handle]);
+        preemption.queued(process);
+        stats.submitted++;
+        if (stats.firstSubmit < 0) stats.firstSubmit = job.arrivalTime;
+        return handle;
+    }
+
+    Dispatch next(long long now) {
+        if (running >= 0) {
+            Process& process = jobs[running];
+            long long ran = std::max(0LL, std::min<long long>(process.remainingTime, now - sliceStart));
+            process.remainingTime -= (int)ran;
+            stats.busyTime -= sliceEnd - now;   // the slice may end early or late
+            lastStop[running] = now;
+            readySince[running] = now;
+            ready.push(running, process, sequence[running]);
+            preemption.queued(process);
+            running = -1;
+        }
+        stats.lastEvent = std::max(stats.lastEvent, now);
+        Dispatch dispatch = {-1, 0, 0};
+        if (ready.empty()) return dispatch;
+
+        int handle = ready.pop();
+        Process& process = jobs[handle];
+        preemption.dispatching(process, now);
+        process.waitingTime += (int)(now - readySince[handle]);
+        if (process.firstRunTime < 0) process.firstRunTime = (int)now;
+        if (handle != lastJob) {
+            lastJob = handle;
+            int refill = costModel.cacheRefill(lastStop[handle] < 0 ? -1 : now - lastStop[handle]);
+            process.contextSwitches++;
+            process.switchTime += costModel.switchCost;
+            process.cacheRefillTime += refill;
+            dispatch.overhead = costModel.switchCost + refill;
+        }
+        dispatch.job = handle;
+        dispatch.slice = preemption.slice(process.remainingTime);
+        running = handle;
+        sliceStart = now + dispatch.overhead;
+        sliceEnd = sliceStart + dispatch.slice;
+        stats.busyTime += dispatch.overhead + dispatch.slice;
+        return dispatch;
+    }
+
+    // The finished job's record, valid until its handle is reused.
+    const Process& complete(int handle, long long now) {
+        if (handle < 0 || handle != running) {
+            throw std::logic_error("complete() takes the job last returned by next()");
+        }
+        Process& process = jobs[handle];
+        stats.busyTime -= sliceEnd - now;
+        running = -1;
+        if (handle == lastJob) lastJob = -1;   // the handle's next job is a different one
+        process.remainingTime = 0;
+        process.completionTime = (int)now;
+        process.turnaroundTime = process.completionTime - process.arrivalTime;
+        lastStop[handle] = now;
+        freeSlots[freeCount++] = handle;
+        stats.completed++;
+        stats.totalWaiting += process.waitingTime;
+        stats.totalTurnaround += process.turnaroundTime;
+        stats.totalResponse += process.responseTime();
+        stats.maxWaiting = std::max<long long>(stats.maxWaiting, process.waitingTime);
+        stats.lastEvent = std::max(stats.lastEvent, now);
+        return process;
+    }
+
+    const Process& job(int handle) const { return jobs[handle]; }
+    const OnlineMetrics& metrics() const { return stats; }
+    int queued() const { return capacity - freeCount - (running >= 0 ? 1 : 0); }
+
+private:
+    int capacity;
+    Arena arena;
+    ReadyQueue ready;
+    Preemption preemption;
+    SwitchCostModel costModel;
+    std::vector<Process> jobs;
+    std::vector<long long> readySince;
+    std::vector<long long> lastStop;
+    std::vector<int> sequence;   // submission order, for ties
+    std::vector<int> freeSlots;
+    int freeCount;
+    int running;
+    int lastJob;
+    long long sliceStart;
+    long long sliceEnd;
+    OnlineMetrics stats;
+};
+
+typedef OnlineEngine<FifoQueue, RunToCompletion> OnlineFcfs;
+typedef OnlineEngine<KeyedQueue<ShortestBurst>, RunToCompletion> OnlineSjf;
+typedef OnlineEngine<FifoQueue, QuantumExpiry> OnlineRoundRobin;
+typedef OnlineEngine<KeyedQueue<HighestPriority>, RunToCompletion> OnlinePriority;
+
+
+// Bounded multi-producer, single-consumer queue for handing jobs to the
+// thread that owns an online engine (Vyukov's ring buffer). A producer
+// claims a slot with one CAS on the tail and publishes it through the
+// slot's sequence number; only the consumer advances the head, so draining
+// needs no read-modify-write at all. tryPush() fails when the ring is full
+// rather than waiting. Capacity is rounded up to a power of two.
+template <typename T>
+class SubmissionQueue {
+public:
+    explicit SubmissionQueue(size_t capacity) : head(0) {
+        size_t size = 2;
+        while (size < capacity) size *= 2;
+        // new Cell[] ignores the cache-line alignment before C++17, so align by hand
+        storage.reset(new char[size * sizeof(Cell) + CACHE_LINE - 1]);
+        std::uintptr_t base = reinterpret_cast<std::uintptr_t>(storage.get());
+        cells = reinterpret_cast<Cell*>((base + CACHE_LINE - 1) & ~(std::uintptr_t)(CACHE_LINE - 1));
+        mask = size - 1;
+        for (size_t i = 0; i < size; i++) {
+            new (&cells[i]) Cell();
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        tail.store(0, std::memory_order_relaxed);
+    }
+
+    ~SubmissionQueue() {
+        for (size_t i = 0; i <= mask; i++) cells[i].~Cell();
+    }
+
+    bool tryPush(const T& item) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[position & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t lag = (std::ptrdiff_t)(sequence - position);
+            if (lag == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.item = item;
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false;   // the consumer has not freed this slot yet
+            } else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only: passes up to `limit` items to fn in queue order
+    // and returns how many.
+    template <typename Fn>
+    size_t drain(Fn fn, size_t limit = (size_t)-1) {
+        size_t count = 0;
+        while (count < limit) {
+            Cell& cell = cells[head & mask];
+            if (cell.sequence.load(std::memory_order_acquire) != head + 1) break;
+            fn(cell.item);
+            cell.sequence.store(head + mask + 1, std::memory_order_release);
+            head++;
+            count++;
+        }
+        return count;
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+private:
+    static const size_t CACHE_LINE = 64;
+
+    struct alignas(CACHE_LINE) Cell {   // one per cache line, so producers do not false-share
+        std::atomic<size_t> sequence;
+        T item;
+    };
+
+    std::unique_ptr<char[]> storage;
+    Cell* cells;
+    size_t mask;
+    alignas(CACHE_LINE) std::atomic<size_t> tail;
+    alignas(CACHE_LINE) size_t head;
+};
+
+#if CPU_SCHED_COROUTINES
+// Return type of a coroutine run by a CoroutineExecutor. It starts
+// suspended; spawning it hands the frame to the executor, which destroys
+// it once the body returns.
+class Task {
+public:
+    struct promise_type {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    explicit Task(std::coroutine_handle<promise_type> h) : handle(h) {}
+    Task(Task&& other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    Task(const Task&) = delete;
+    ~Task() { if (handle) handle.destroy(); }
+
+    std::coroutine_handle<> release() {
+        std::coroutine_handle<> frame = handle;
+        handle = nullptr;
+        return frame;
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle;
+};
+
+// In-process scheduler for coroutine tasks, with the engines' ready queues
+// choosing what runs next: FifoQueue is FCFS (round robin for tasks that
+// yield), BucketQueue<ShortestBurst> SJF on the burst hint given to spawn()
+// and BucketQueue<HighestPriority> priority. spawn() queues a task and
+// returns its handle, -1 when all `capacity` slots are in use. A task
+// gives up the thread with `co_await executor.yield()`, which requeues it
+// behind the queued tasks with the same key; it must not suspend any
+// other way. run() resumes tasks until none is ready and returns the
+// number of resumes. Equal keys go to the earlier (re)queue (exactly with
+// BucketQueue; KeyedQueue's counter wraps after 2^31). Single-threaded: tasks may spawn more tasks, but
+// only from run()'s thread. Queue storage is sized in the constructor.
+template <typename ReadyQueue>
+class CoroutineExecutor {
+public:
+    class YieldAwaiter {
+    public:
+        explicit YieldAwaiter(CoroutineExecutor& executor) : executor(executor) {}
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<>) const { executor.queue(executor.current); }
+        void await_resume() const noexcept {}
+
+    private:
+        CoroutineExecutor& executor;
+    };
+
+    explicit CoroutineExecutor(int capacity)
+        : capacity(std::max(capacity, 1)), ready(this->capacity, arena), tasks(this->capacity),
+          hints(this->capacity), freeSlots(this->capacity), freeCount(this->capacity), current(-1),
+          sequence(0) {
+        for (int k = 0; k < this->capacity; k++) freeSlots[k] = this->capacity - 1 - k;
+    }
+
+    CoroutineExecutor(const CoroutineExecutor&) = delete;
+
+    ~CoroutineExecutor() {
+        for (auto& task : tasks) {
+            if (task) task.destroy();
+        }
+    }
+
+    int spawn(Task task, int burstHint = 0, int priority = 0) {
+        if (freeCount == 0) return -1;
+        int handle = freeSlots[--freeCount];
+        tasks[handle] = task.release();
+        hints[handle].burstTime = burstHint;
+        hints[handle].priority = priority;
+        queue(handle);
+        return handle;
+    }
+
+    YieldAwaiter yield() { return YieldAwaiter(*this); }
+
+    long long run() {
+        long long resumes = 0;
+        while (!ready.empty()) {
+            current = ready.pop();
+            std::coroutine_handle<> task = tasks[current];
+            task.resume();
+            resumes++;
+            if (task.done()) {
+                task.destroy();
+                tasks[current] = nullptr;
+                freeSlots[freeCount++] = current;
+            }
+        }
+        current = -1;
+        return resumes;
+    }
+
+    int running() const { return current; }   // handle of the task being resumed, -1 = none
+    int active() const { return capacity - freeCount; }
+
+private:
+    // the queues take a Process; the hints stay 8 bytes a task so requeues stay in cache
+    void queue(int handle) {
+        key.burstTime = hints[handle].burstTime;
+        key.priority = hints[handle].priority;
+        ready.push(handle, key, (int)(sequence++ & 0x7fffffff));
+    }
+
+    struct Hint {
+        int burstTime;
+        int priority;
+    };
+
+    int capacity;
+    Arena arena;
+    ReadyQueue ready;
+    std::vector<std::coroutine_handle<>> tasks;
+    std::vector<Hint> hints;   // for keyed queues
+    Process key;
+    std::vector<int> freeSlots;
+    int freeCount;
+    int current;
+    unsigned sequence;
+};
+
+typedef CoroutineExecutor<FifoQueue> FcfsExecutor;
+typedef CoroutineExecutor<BucketQueue<ShortestBurst>> SjfExecutor;
+typedef CoroutineExecutor<FifoQueue> RoundRobinExecutor;   // tasks yield once per slice
+typedef CoroutineExecutor<BucketQueue<HighestPriority>> PriorityExecutor;
+#endif
+
+#endif
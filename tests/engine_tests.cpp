@@ -0,0 +1,1363 @@
+/**
+ * CPU Scheduling Algorithm Simulator - Engine Tests
+ *
+ * Equivalence checks run by ctest, one suite per argument:
+ *   cfs         CFS fairness by weight, work conservation and the 32-bit
+ *               overflow check
+ *   realtime    EDF and rate monotonic against a unit-step reference,
+ *               and the textbook set RM misses but EDF meets
+ *   bursts      CPU/I-O burst sequences: single bursts against the
+ *               engines, and CPU, device and waiting time accounting
+ *   predictor   exponential-average burst prediction, and predicted SJF
+ *               and SRTF with a frozen estimate against FCFS
+ *   metrics     ScheduleMetrics against brute force: averages, sliding
+ *               window extremes, utilization and fairness
+ *   event_queue the calendar queue and timing wheel against the binary
+ *               heap, alone and under the burst engine
+ *   adaptive_rr OrderStatistic against a sorted multiset, and adaptive
+ *               Round Robin against a linear-scan reference
+ *   typedefs    SchedulingEngine's FCFS/SJF/RR/Priority against a plain
+ *               reference scan, with and without switch cost
+ *   c_library   the C library (C file/sched.c) against the C++ engines
+ *   radix_sort  RadixSort against std::stable_sort, 32- and 64-bit keys, and
+ *               sortedByArrival on both sides of the merge/radix crossover
+ *   trace       slices reported to a SliceSink against each run's results,
+ *               and the Chrome trace JSON written from them
+ *   parallel_fcfs the parallel FCFS scan against serial FCFS, sorted and
+ *               unsorted input, 1 to 8 threads
+ *   checkpoint  CFS, EDF and burst runs resumed from a snapshot against
+ *               uninterrupted runs, and the fallback for a foreign snapshot
+ *   ready_queue BucketQueue against KeyedQueue under rising push order
+ *   online      the online engines, fed arrivals as they happen, against
+ *               the batch engines, adaptive Round Robin included
+ *   monte_carlo Monte Carlo results on 1 to 7 threads
+ *   ftrace      trace import: bursts and waiting, CPU filtering, and the
+ *               rejection of traces past the 32-bit microsecond limit
+ *   gang        gang scheduling with and without backfilling: core capacity,
+ *               arrival-order starts, and a backfilled job
+ *   cluster     one-node clusters against the engines, results on 1 to 8
+ *               threads, and the quantum check
+ *   energy      DVFS at full speed against the engines, energy-aware
+ *               savings and accounting, and the quantum check
+ * The console engines come from console_main.cpp, compiled in without its
+ * main. Exits non-zero when any check fails.
+ */
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <map>
+#include <set>
+#include <memory>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <cstddef>
+#include <cstdint>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include "scheduler_core.h"
+#define CPU_SCHED_NO_MAIN
+#include "../console_main.cpp"
+
+// the C library has its own struct Process; keep it out of the way
+namespace csched {
+#include "../C file/sched.h"
+}
+
+using namespace std;
+
+static int failures = 0;
+
+static void check(bool ok, const string& what) {
+    if (!ok) {
+        failures++;
+        cout << "FAIL: " << what << "\n";
+    }
+}
+
+enum Policy { FCFS, SJF, RR, PRIORITY };
+static const char* policyNames[] = {"FCFS", "SJF", "Round Robin", "Priority"};
+
+// Random workload; `maxGap` 0 puts every arrival at time 0 and small gaps
+// give plenty of equal arrival times, bursts and priorities.
+static vector<Process> workload(mt19937& rng, int n, int maxGap, int maxBurst) {
+    vector<Process> processes;
+    int arrival = 0;
+    for (int i = 0; i < n; i++) {
+        arrival += maxGap > 0 ? rng() % maxGap : 0;
+        processes.push_back(Process(i + 1, arrival, 1 + rng() % maxBurst, rng() % 5));
+    }
+    shuffle(processes.begin(), processes.end(), rng);   // input order != arrival order
+    return processes;
+}
+
+static vector<Process> byArrival(vector<Process> processes) {
+    stable_sort(processes.begin(), processes.end(),
+                [](const Process& a, const Process& b) { return a.arrivalTime < b.arrivalTime; });
+    return processes;
+}
+
+// The engines' rules written as a linear scan: jobs arrived by now join the
+// queue in input order, the policy picks from the whole queue, a fixed
+// switch cost is charged whenever the CPU changes job.
+static vector<Process> referenceScan(vector<Process> processes, Policy policy, int quantum, int switchCost) {
+    int n = processes.size();
+    vector<bool> released(n, false);
+    deque<int> ready;
+    long long now = 0;
+    int completed = 0, last = -1;
+    for (auto& process : processes) process.remainingTime = process.burstTime;
+    auto release = [&]() {
+        for (int i = 0; i < n; i++) {
+            if (!released[i] && processes[i].arrivalTime <= now) {
+                released[i] = true;
+                ready.push_back(i);
+            }
+        }
+    };
+
+    release();
+    while (completed < n) {
+        if (ready.empty()) {
+            long long next = -1;
+            for (int i = 0; i < n; i++) {
+                if (!released[i] && (next < 0 || processes[i].arrivalTime < next)) next = processes[i].arrivalTime;
+            }
+            now = next;
+            release();
+            continue;
+        }
+
+        size_t pick = 0;
+        for (size_t k = 1; k < ready.size(); k++) {
+            const Process& a = processes[ready[k]];
+            const Process& b = processes[ready[pick]];
+            bool better = false;
+            if (policy == SJF) better = a.burstTime < b.burstTime || (a.burstTime == b.burstTime && ready[k] < ready[pick]);
+            if (policy == PRIORITY) better = a.priority < b.priority || (a.priority == b.priority && ready[k] < ready[pick]);
+            if (better) pick = k;
+        }
+        int i = ready[pick];
+        ready.erase(ready.begin() + pick);
+        Process& process = processes[i];
+        if (process.firstRunTime < 0) process.firstRunTime = (int)now;
+        if (i != last) {
+            last = i;
+            process.contextSwitches++;
+            process.switchTime += switchCost;
+            now += switchCost;
+        }
+        int slice = policy == RR ? min(quantum, process.remainingTime) : process.remainingTime;
+        now += slice;
+        process.remainingTime -= slice;
+        release();
+        if (process.remainingTime == 0) {
+            process.completionTime = (int)now;
+            process.turnaroundTime = process.completionTime - process.arrivalTime;
+            process.waitingTime = process.turnaroundTime - process.burstTime - process.switchOverhead();
+            completed++;
+        } else {
+            ready.push_back(i);
+        }
+    }
+    return processes;
+}
+
+static vector<Process> runEngine(vector<Process> processes, Policy policy, int quantum,
+                                 const SwitchCostModel& cost) {
+    switch (policy) {
+        case FCFS: FcfsEngine::run(processes, RunToCompletion(), cost, "FCFS"); break;
+        case SJF: SjfEngine::run(processes, RunToCompletion(), cost, "SJF"); break;
+        case RR: RoundRobinEngine::run(processes, QuantumExpiry(quantum), cost, "Round Robin"); break;
+        case PRIORITY: PriorityEngine::run(processes, RunToCompletion(), cost, "Priority"); break;
+    }
+    return processes;
+}
+
+static vector<Process> byId(vector<Process> processes) {
+    sort(processes.begin(), processes.end(), [](const Process& a, const Process& b) { return a.id < b.id; });
+    return processes;
+}
+
+static bool sameTiming(const vector<Process>& a, const vector<Process>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].id != b[i].id || a[i].completionTime != b[i].completionTime || a[i].waitingTime != b[i].waitingTime ||
+            a[i].firstRunTime != b[i].firstRunTime || a[i].contextSwitches != b[i].contextSwitches) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void testCfs() {
+    // equal weights: when the first job finishes, the others trail it by at
+    // most a slice each (slice = latency / n, at least the granularity)
+    for (int n : {1, 2, 5, 6, 13}) {
+        const int burst = 40;
+        vector<Process> processes;
+        for (int i = 0; i < n; i++) processes.push_back(Process(i + 1, 0, burst));
+        vector<Process> result = CPUScheduler::cfs(processes, 6, 1);
+        int first = INT_MAX, last = 0;
+        for (const Process& process : result) {
+            first = min(first, process.completionTime);
+            last = max(last, process.completionTime);
+        }
+        int slice = max(1, 6 / n);
+        check(last == n * burst && first >= n * burst - (n - 1) * slice,
+              "CFS equal weights share the CPU, " + to_string(n) + " jobs");
+    }
+
+    // nice 0 against nice 5: CPU time in the ratio of the weights, 1024:335
+    vector<Process> niced = {Process(1, 0, 3000, 0), Process(2, 0, 3000, 5)};
+    vector<Process> weighted = CPUScheduler::cfs(niced, 6, 1);
+    double ratio = 3000.0 / (weighted[0].completionTime - 3000);
+    check(weighted[0].completionTime < weighted[1].completionTime && fabs(ratio - 1024.0 / 335) < 0.1,
+          "CFS shares the CPU by weight (ratio " + to_string(ratio) + ")");
+
+    mt19937 rng(26);
+    for (int round = 0; round < 100; round++) {
+        vector<Process> processes = workload(rng, 1 + rng() % 80, rng() % 10, 30);
+        for (Process& process : processes) process.priority = (int)(rng() % 40) - 20;
+        vector<Process> result = CPUScheduler::cfs(processes, 1 + rng() % 12, 1 + rng() % 3);
+        int makespan = 0;
+        bool consistent = true;
+        for (const Process& process : result) {
+            makespan = max(makespan, process.completionTime);
+            consistent = consistent && process.waitingTime >= 0 && process.remainingTime == 0 &&
+                         process.turnaroundTime == process.completionTime - process.arrivalTime &&
+                         process.waitingTime == process.turnaroundTime - process.burstTime;
+        }
+        int fcfsMakespan = 0;
+        for (const Process& process : CPUScheduler::fcfs(processes)) {
+            fcfsMakespan = max(fcfsMakespan, process.completionTime);
+        }
+        // without switch costs every work-conserving policy ends together
+        check(consistent && makespan == fcfsMakespan, "CFS work conservation, round " + to_string(round));
+    }
+
+    bool thrown = false;
+    try {
+        CPUScheduler::cfs({Process(1, INT_MAX - 5, 10)});
+    } catch (const overflow_error&) {
+        thrown = true;
+    }
+    check(thrown, "CFS rejects times past the 32-bit fields");
+}
+
+// EDF or RM one time unit at a time: every instance released before the
+// horizon runs to completion, the smallest (key, index) runs each unit.
+static DeadlineStats referenceRealTime(vector<Process>& processes, int horizon, bool earliestDeadline) {
+    const long long NO_DEADLINE = LLONG_MAX / 4;
+    int n = processes.size();
+    vector<deque<long long>> released(n);
+    vector<long long> nextRelease(n), remaining(n);
+    vector<bool> more(n, true);
+    auto relative = [&](int i) -> long long {
+        if (processes[i].deadline > 0) return processes[i].deadline;
+        return processes[i].period > 0 ? processes[i].period : NO_DEADLINE;
+    };
+    for (int i = 0; i < n; i++) {
+        nextRelease[i] = processes[i].arrivalTime;
+        processes[i].turnaroundTime = 0;
+    }
+    DeadlineStats stats;
+    for (long long now = 0;;) {
+        int best = -1;
+        long long bestKey = 0, nextEvent = LLONG_MAX;
+        for (int i = 0; i < n; i++) {
+            while (more[i] && nextRelease[i] <= now) {
+                if (released[i].empty()) remaining[i] = processes[i].burstTime;
+                released[i].push_back(nextRelease[i]);
+                if (processes[i].period > 0 && nextRelease[i] + processes[i].period < horizon) {
+                    nextRelease[i] += processes[i].period;
+                } else {
+                    more[i] = false;
+                }
+            }
+            if (more[i]) nextEvent = min(nextEvent, nextRelease[i]);
+            if (released[i].empty()) continue;
+            long long key = earliestDeadline ? released[i].front() + relative(i)
+                                             : processes[i].period > 0 ? processes[i].period : relative(i);
+            if (best < 0 || key < bestKey) {
+                best = i;
+                bestKey = key;
+            }
+        }
+        if (best < 0) {
+            if (nextEvent == LLONG_MAX) break;
+            now = nextEvent;
+            continue;
+        }
+        now++;
+        if (--remaining[best] > 0) continue;
+        long long response = now - released[best].front();
+        processes[best].completionTime = (int)now;
+        processes[best].turnaroundTime = max<int>(processes[best].turnaroundTime, (int)response);
+        if (relative(best) != NO_DEADLINE) stats.record(response - relative(best));
+        released[best].pop_front();
+        remaining[best] = processes[best].burstTime;
+    }
+    return stats;
+}
+
+static void testRealTime() {
+    // U = 2/5 + 4/7 > the RM bound: RM misses the second task's deadline at 7, EDF never misses
+    vector<Process> textbook = {Process(1, 0, 2, 0, 0, 5), Process(2, 0, 4, 0, 0, 7)};
+    DeadlineStats edfStats, rmStats;
+    CPUScheduler::edf(textbook, 35, edfStats);
+    CPUScheduler::rateMonotonic(textbook, 35, rmStats);
+    check(edfStats.misses == 0 && edfStats.instances == 12, "EDF meets every deadline at U = 0.97");
+    check(rmStats.misses > 0 && rmStats.maxLateness >= 1, "RM misses a deadline at U = 0.97");
+
+    mt19937 rng(27);
+    for (int round = 0; round < 300; round++) {
+        int n = 1 + rng() % 6, horizon = 20 + rng() % 200;
+        vector<Process> processes;
+        for (int i = 0; i < n; i++) {
+            int period = rng() % 4 == 0 ? 0 : 3 + rng() % 30;
+            int burst = 1 + rng() % (period > 0 ? max(1, period / 2) : 10);
+            int deadline = rng() % 3 == 0 ? 1 + rng() % 40 : 0;
+            processes.push_back(Process(i + 1, rng() % 20, burst, 0, deadline, period));
+        }
+        string tag = " (round " + to_string(round) + ")";
+        for (bool earliestDeadline : {true, false}) {
+            DeadlineStats stats;
+            vector<Process> result = earliestDeadline ? CPUScheduler::edf(processes, horizon, stats)
+                                                      : CPUScheduler::rateMonotonic(processes, horizon, stats);
+            vector<Process> expected = processes;
+            DeadlineStats reference = referenceRealTime(expected, horizon, earliestDeadline);
+            bool same = stats.instances == reference.instances && stats.misses == reference.misses &&
+                        stats.totalLateness == reference.totalLateness && stats.maxLateness == reference.maxLateness;
+            for (int i = 0; i < n; i++) {
+                same = same && result[i].completionTime == expected[i].completionTime &&
+                       result[i].turnaroundTime == expected[i].turnaroundTime;
+            }
+            check(same, string(earliestDeadline ? "EDF" : "RM") + " vs unit-step reference" + tag);
+        }
+    }
+}
+
+// Random CPU/I-O burst sequences, one to four CPU bursts per job.
+static BurstTable burstTable(mt19937& rng, int jobs, int devices) {
+    BurstTable bursts;
+    for (int i = 0; i < jobs; i++) {
+        int slots = 1 + 2 * (rng() % 4);
+        for (int k = 0; k < slots; k++) {
+            if (k % 2 == 0) bursts.addCpuBurst(1 + rng() % 12);
+            else bursts.addIoBurst(1 + rng() % 20, rng() % devices);
+        }
+        bursts.endJob();
+    }
+    return bursts;
+}
+
+static void testBursts() {
+    // CPU 3, I/O 5, CPU 2 alone on the machine: no waiting anywhere
+    vector<Process> single = {Process(1, 4, 0)};
+    BurstTable pattern;
+    pattern.addCpuBurst(3);
+    pattern.addIoBurst(5, 0);
+    pattern.addCpuBurst(2);
+    pattern.endJob();
+    UtilizationStats stats;
+    vector<Process> alone = CPUScheduler::burstSequences(single, pattern, 1, POLICY_FCFS, 2, stats);
+    check(alone[0].completionTime == 14 && alone[0].waitingTime == 0 && alone[0].burstTime == 5 &&
+              stats.cpuBusy == 5 && stats.deviceBusy[0] == 5,
+          "bursts of a lone job run back to back");
+
+    mt19937 rng(29);
+    for (int round = 0; round < 100; round++) {
+        int n = 1 + rng() % 60, devices = 1 + rng() % 3, quantum = 1 + rng() % 4;
+        vector<Process> processes = byArrival(workload(rng, n, rng() % 8, 12));
+        string tag = " (round " + to_string(round) + ")";
+
+        // one CPU burst each: the plain engines' schedules
+        BurstTable cpuOnly;
+        for (const Process& process : processes) {
+            cpuOnly.addCpuBurst(process.burstTime);
+            cpuOnly.endJob();
+        }
+        for (int policy = FCFS; policy <= PRIORITY; policy++) {
+            vector<Process> result = CPUScheduler::burstSequences(processes, cpuOnly, 1, (CpuPolicy)policy,
+                                                                  quantum, stats);
+            check(sameTiming(byId(result), byId(runEngine(processes, (Policy)policy, quantum, SwitchCostModel()))),
+                  string("single bursts vs ") + policyNames[policy] + tag);
+        }
+
+        // without switch costs a job's life is CPU, I/O, CPU queueing and device queueing
+        BurstTable bursts = burstTable(rng, n, devices);
+        for (int policy = FCFS; policy <= PRIORITY; policy++) {
+            vector<Process> result = CPUScheduler::burstSequences(processes, bursts, devices, (CpuPolicy)policy,
+                                                                  quantum, stats);
+            long long cpu = 0, io = 0, unexplained = 0;
+            vector<long long> deviceTime(devices, 0), requests(devices, 0);
+            for (int i = 0; i < n; i++) {
+                long long jobCpu = 0, jobIo = 0;
+                for (int k = bursts.offsets[i]; k < bursts.offsets[i + 1]; k++) {
+                    if (bursts.devices[k] < 0) {
+                        jobCpu += bursts.lengths[k];
+                    } else {
+                        jobIo += bursts.lengths[k];
+                        deviceTime[bursts.devices[k]] += bursts.lengths[k];
+                        requests[bursts.devices[k]]++;
+                    }
+                }
+                cpu += jobCpu;
+                io += jobIo;
+                unexplained += result[i].turnaroundTime - jobCpu - jobIo - result[i].waitingTime;
+                check(result[i].burstTime == jobCpu, "burst totals per job" + tag);
+            }
+            long long queued = accumulate(stats.deviceQueueWait.begin(), stats.deviceQueueWait.end(), 0LL);
+            check(stats.cpuBusy == cpu && stats.deviceBusy == deviceTime && stats.deviceRequests == requests &&
+                      unexplained == queued,
+                  string("burst accounting, ") + policyNames[policy] + tag);
+        }
+    }
+}
+
+static void testPredictor() {
+    // the textbook sequence: alpha 1/2 from tau 10
+    BurstPredictor textbook(0.5, 10);
+    textbook.reset({Process(1, 0, 0)});
+    const int bursts[] = {6, 4, 6, 4, 13, 13, 13};
+    const double expected[] = {10, 8, 6, 6, 5, 9, 11, 12};
+    bool same = textbook.predict(0) == expected[0];
+    for (int k = 0; k < 7; k++) {
+        textbook.observe(0, bursts[k]);
+        same = same && textbook.predict(0) == expected[k + 1];
+    }
+    check(same && textbook.observationCount() == 7, "exponential average follows the textbook sequence");
+
+    // jobs sharing a process id share one estimate
+    BurstPredictor shared(0.5, 10);
+    shared.reset({Process(7, 0, 0), Process(8, 0, 0), Process(7, 5, 0)});
+    shared.observe(0, 2);
+    check(shared.taskCount() == 2 && shared.predict(2) == 6 && shared.predict(1) == 10,
+          "jobs of one task share its estimate");
+
+    mt19937 rng(49);
+    for (int round = 0; round < 60; round++) {
+        int n = 1 + rng() % 60, devices = 1 + rng() % 3;
+        vector<Process> processes = workload(rng, n, rng() % 10, 12);
+        for (Process& process : processes) process.id = 1 + rng() % (n / 2 + 1);   // recurring tasks
+        BurstTable table = burstTable(rng, n, devices);
+        long long cpuBursts = 0;
+        for (int device : table.devices) cpuBursts += device < 0;
+        set<int> tasks;
+        for (const Process& process : processes) tasks.insert(process.id);
+        string tag = " (round " + to_string(round) + ")";
+
+        UtilizationStats stats;
+        vector<Process> fcfs = CPUScheduler::burstSequences(processes, table, devices, POLICY_FCFS, 2, stats);
+        // alpha 0 never moves an estimate, so every key ties and the ready queue stays FIFO
+        for (CpuPolicy policy : {POLICY_SJF_PREDICTED, POLICY_SRTF_PREDICTED}) {
+            BurstPredictor frozen(0.0, 5);
+            vector<Process> result = CPUScheduler::burstSequences(processes, table, devices, policy, 2, stats,
+                                                                  SwitchCostModel(), EVENT_QUEUE_HEAP,
+                                                                  CheckpointOptions(), &frozen);
+            string name = policy == POLICY_SJF_PREDICTED ? "predicted SJF" : "predicted SRTF";
+            check(sameTiming(result, fcfs), name + " with a frozen estimate is FCFS" + tag);
+            check(frozen.observationCount() == cpuBursts && frozen.taskCount() == (int)tasks.size(),
+                  name + " feeds every CPU burst to the predictor" + tag);
+        }
+    }
+}
+
+static bool near(double a, double b) { return fabs(a - b) <= 1e-9 * max(1.0, fabs(b)); }
+
+static void testMetrics() {
+    mt19937 rng(50);
+    for (int round = 0; round < 2000; round++) {
+        int n = 1 + rng() % 80;
+        vector<Process> processes;
+        for (int i = 0; i < n; i++) {
+            Process process(i + 1, rng() % 300, 1 + rng() % 20);
+            process.completionTime = process.arrivalTime + process.burstTime + rng() % 200;
+            process.turnaroundTime = process.completionTime - process.arrivalTime;
+            process.waitingTime = process.turnaroundTime - process.burstTime;
+            process.firstRunTime = process.arrivalTime + rng() % (process.waitingTime + 1);
+            processes.push_back(process);
+        }
+        long long window = 1 + rng() % 100;
+        ScheduleMetrics metrics = ScheduleMetrics::of(processes, 1, window);
+
+        long long first = LLONG_MAX, last = 0;
+        double waiting = 0, turnaround = 0, response = 0, slowdown = 0, maxSlowdown = 0, share = 0, shareSquares = 0;
+        int maxWaiting = 0;
+        for (const Process& process : processes) {
+            first = min<long long>(first, process.arrivalTime);
+            last = max<long long>(last, process.completionTime);
+            waiting += process.waitingTime;
+            turnaround += process.turnaroundTime;
+            response += process.firstRunTime - process.arrivalTime;
+            maxWaiting = max(maxWaiting, process.waitingTime);
+            double ratio = (double)process.burstTime / process.turnaroundTime;
+            slowdown += 1 / ratio;
+            maxSlowdown = max(maxSlowdown, 1 / ratio);
+            share += ratio;
+            shareSquares += ratio * ratio;
+        }
+        string tag = " (round " + to_string(round) + ")";
+        check(metrics.jobs == n && metrics.span == last - first && near(metrics.averageWaiting, waiting / n) &&
+                  near(metrics.averageTurnaround, turnaround / n) && near(metrics.averageResponse, response / n) &&
+                  metrics.maxWaiting == maxWaiting && near(metrics.averageSlowdown, slowdown / n) &&
+                  near(metrics.maxSlowdown, maxSlowdown) && near(metrics.fairness, share * share / (n * shareSquares)),
+              "metric averages vs brute force" + tag);
+        if (last - first <= window) continue;
+
+        // every window (t, t + window] for integer t; the fewest only counts windows inside the span
+        int peak = 0, low = INT_MAX;
+        for (long long t = first - window; t <= last; t++) {
+            int count = 0;
+            for (const Process& process : processes) {
+                count += process.completionTime > t && process.completionTime <= t + window;
+            }
+            peak = max(peak, count);
+            if (t >= first && t + window <= last) low = min(low, count);
+        }
+        check(metrics.peakWindowJobs == peak && metrics.lowWindowJobs == low, "sliding window extremes" + tag);
+    }
+
+    // back-to-back jobs from time 0 keep the CPU busy and get equal shares only if equally long
+    vector<Process> busy = CPUScheduler::fcfs({Process(1, 0, 4), Process(2, 0, 4), Process(3, 0, 4)});
+    ScheduleMetrics full = ScheduleMetrics::of(busy);
+    check(full.cpuUtilization == 1 && full.span == 12 && near(full.averageWaiting, 4) && full.peakWindowJobs >= 1,
+          "FCFS back to back uses the whole span");
+    check(ScheduleMetrics::of(busy, 4).cpuUtilization == -1, "utilization is left unknown on several CPUs");
+    vector<Process> alone = CPUScheduler::fcfs({Process(1, 0, 5), Process(2, 100, 5)});
+    check(ScheduleMetrics::of(alone).fairness == 1 && near(ScheduleMetrics::of(alone).cpuUtilization, 10.0 / 105),
+          "jobs that never wait get equal shares");
+}
+
+static void testEventQueues() {
+    mt19937_64 rng(30);
+    for (int round = 0; round < 60; round++) {
+        vector<unique_ptr<EventQueue>> queues;
+        for (int k = 0; k < 3; k++) queues.push_back(EventQueue::create((EventQueueKind)k));
+        // dense, spread and sparse gaps, with now and then a far-future event
+        long long range = round % 4 == 0 ? 1 : round % 4 == 1 ? 100 : round % 4 == 2 ? 100000 : 1 << 30;
+        long long seq = 0, now = 0, pending = 0;
+        bool same = true;
+        for (int step = 0; step < 20000 && same; step++) {
+            if (pending == 0 || rng() % 3 != 0) {
+                long long time = now + (long long)(rng() % range) * (rng() % 50 == 0 ? 100000 : 1);
+                if (rng() % 1000 == 0) time = now + (1LL << 40) + rng() % 1000;
+                for (auto& queue : queues) queue->push(SimEvent(time, seq, SimEvent::ARRIVAL, (int)(seq % 97)));
+                seq++;
+                pending++;
+            } else {
+                SimEvent first = queues[0]->top();
+                for (int k = 1; k < 3; k++) {
+                    SimEvent event = queues[k]->top();
+                    same = same && event.time == first.time && event.seq == first.seq && event.job == first.job;
+                }
+                for (auto& queue : queues) queue->pop();
+                now = first.time;
+                pending--;
+            }
+        }
+        while (same && pending-- > 0) {
+            SimEvent first = queues[0]->top();
+            for (int k = 1; k < 3; k++) same = same && queues[k]->top().seq == first.seq;
+            for (auto& queue : queues) queue->pop();
+        }
+        for (auto& queue : queues) same = same && queue->empty();
+        check(same, "event queues vs binary heap, round " + to_string(round));
+    }
+
+    mt19937 small(30);
+    for (int round = 0; round < 40; round++) {
+        int n = 1 + small() % 200, devices = 1 + small() % 3;
+        vector<Process> processes = workload(small, n, small() % 30, 12);
+        BurstTable bursts = burstTable(small, n, devices);
+        SwitchCostModel cost(small() % 2, small() % 3, 10);
+        CpuPolicy policy = (CpuPolicy)(small() % 4);
+        UtilizationStats heapStats;
+        vector<Process> heap = CPUScheduler::burstSequences(processes, bursts, devices, policy, 3, heapStats, cost,
+                                                            EVENT_QUEUE_HEAP);
+        for (int kind = 1; kind < 3; kind++) {
+            UtilizationStats stats;
+            vector<Process> result = CPUScheduler::burstSequences(processes, bursts, devices, policy, 3, stats, cost,
+                                                                  (EventQueueKind)kind);
+            check(sameTiming(result, heap) && stats.makespan == heapStats.makespan &&
+                      stats.deviceQueueWait == heapStats.deviceQueueWait,
+                  "burst engine on event queue " + to_string(kind) + " vs heap, round " + to_string(round));
+        }
+    }
+}
+
+// Adaptive Round Robin as a linear scan, without switch costs: each round
+// starts with the percentile of the queued jobs' remaining times.
+static vector<Process> referenceAdaptive(vector<Process> processes, double percentile,
+                                         vector<QuantumStep>& trajectory) {
+    int n = processes.size();
+    double fraction = min(100.0, max(0.0, percentile)) / 100.0;
+    vector<bool> released(n, false);
+    deque<int> ready;
+    long long now = 0;
+    int completed = 0, quantum = 0, roundLeft = 0;
+    for (auto& process : processes) process.remainingTime = process.burstTime;
+    auto release = [&]() {
+        for (int i = 0; i < n; i++) {
+            if (!released[i] && processes[i].arrivalTime <= now) {
+                released[i] = true;
+                ready.push_back(i);
+            }
+        }
+    };
+
+    release();
+    while (completed < n) {
+        if (ready.empty()) {
+            long long next = LLONG_MAX;
+            for (int i = 0; i < n; i++) {
+                if (!released[i]) next = min<long long>(next, processes[i].arrivalTime);
+            }
+            now = next;
+            release();
+            continue;
+        }
+        if (roundLeft == 0) {
+            vector<int> remaining;
+            for (int i : ready) remaining.push_back(processes[i].remainingTime);
+            sort(remaining.begin(), remaining.end());
+            int queued = remaining.size();
+            int rank = max(1, (int)ceil(fraction * queued));
+            int next = max(1, remaining[rank - 1]);
+            if (next != quantum) trajectory.push_back({now, next, queued});
+            quantum = next;
+            roundLeft = queued;
+        }
+        roundLeft--;
+        int i = ready.front();
+        ready.pop_front();
+        Process& process = processes[i];
+        int slice = min(quantum, process.remainingTime);
+        now += slice;
+        process.remainingTime -= slice;
+        release();
+        if (process.remainingTime == 0) {
+            process.completionTime = (int)now;
+            completed++;
+        } else {
+            ready.push_back(i);
+        }
+    }
+    return processes;
+}
+
+static void testAdaptiveRoundRobin() {
+    mt19937 rng(48);
+    for (int maxValue : {1, 7, 1000, (1 << 20) + 5, 2000000000}) {
+        SimulationContext::Scope scratch;
+        OrderStatistic stat(maxValue);
+        multiset<int> values;
+        int shift = 0;
+        while ((maxValue >> shift) >= OrderStatistic::MAX_SLOTS) shift++;
+        bool same = true;
+        for (int step = 0; step < 20000 && same; step++) {
+            if (values.empty() || rng() % 3 != 0) {
+                int value = rng() % ((unsigned)maxValue + 1);
+                stat.insert(value);
+                values.insert(value);
+            } else {
+                auto it = values.begin();
+                advance(it, rng() % values.size());
+                stat.erase(*it);
+                values.erase(it);
+            }
+            if (values.empty()) continue;
+            int k = 1 + rng() % values.size();
+            auto it = values.begin();
+            advance(it, k - 1);
+            // wide ranges share slots and answer with the slot's upper end
+            int expected = (int)min<long long>(maxValue, (((long long)(*it >> shift) + 1) << shift) - 1);
+            same = stat.size() == (int)values.size() && stat.kth(k) == expected;
+        }
+        check(same, "OrderStatistic vs multiset, values up to " + to_string(maxValue));
+    }
+
+    for (int round = 0; round < 100; round++) {
+        vector<Process> processes = workload(rng, 1 + rng() % 150, rng() % 6, 1 + rng() % 40);
+        double percentile = round % 5 == 0 ? 0 : round % 5 == 1 ? 100 : rng() % 101;
+        vector<QuantumStep> trajectory, expectedTrajectory;
+        vector<Process> result = CPUScheduler::adaptiveRoundRobin(processes, percentile, &trajectory);
+        vector<Process> expected = referenceAdaptive(processes, percentile, expectedTrajectory);
+        bool same = trajectory.size() == expectedTrajectory.size();
+        for (size_t k = 0; same && k < trajectory.size(); k++) {
+            same = trajectory[k].time == expectedTrajectory[k].time &&
+                   trajectory[k].quantum == expectedTrajectory[k].quantum &&
+                   trajectory[k].queued == expectedTrajectory[k].queued;
+        }
+        for (size_t i = 0; i < processes.size(); i++) {
+            same = same && result[i].completionTime == expected[i].completionTime;
+        }
+        check(same, "adaptive Round Robin vs reference, percentile " + to_string(percentile) + ", round " +
+                        to_string(round));
+    }
+
+    // everything queued at once with the 100th percentile: one slice each, FCFS order
+    vector<Process> together = workload(rng, 50, 0, 30);
+    check(sameTiming(CPUScheduler::adaptiveRoundRobin(together, 100), runEngine(together, FCFS, 0, SwitchCostModel())),
+          "adaptive Round Robin at the 100th percentile is FCFS");
+}
+
+static void testTypedefs() {
+    mt19937 rng(1);
+    for (int round = 0; round < 40; round++) {
+        int n = 1 + rng() % 300, quantum = 1 + rng() % 5, switchCost = round % 2;
+        vector<Process> processes = workload(rng, n, round % 3 == 0 ? 0 : 1 + rng() % 12, 1 + rng() % 30);
+        for (int policy = FCFS; policy <= PRIORITY; policy++) {
+            // FcfsEngine takes its input pre-sorted by arrival
+            vector<Process> input = policy == FCFS ? byArrival(processes) : processes;
+            vector<Process> expected = referenceScan(input, (Policy)policy, quantum, switchCost);
+            vector<Process> actual = runEngine(input, (Policy)policy, quantum, SwitchCostModel(switchCost));
+            check(sameTiming(expected, actual), string(policyNames[policy]) + " engine vs reference scan, round " +
+                                                    to_string(round));
+        }
+    }
+}
+
+static void testCLibrary() {
+    mt19937 rng(2);
+    vector<char> workspace;
+    for (int round = 0; round < 40; round++) {
+        int n = 1 + rng() % (round % 4 == 0 ? 5000 : 200), quantum = 1 + rng() % 5;
+        vector<Process> processes = workload(rng, n, rng() % 10, 1 + rng() % 20);
+        workspace.resize(csched::sched_workspace_size(n));
+        for (int policy = FCFS; policy <= PRIORITY; policy++) {
+            vector<csched::Process> c(n);
+            for (int i = 0; i < n; i++) {
+                csched::Process entry = {processes[i].id, processes[i].arrivalTime, processes[i].burstTime,
+                                         processes[i].priority, 0, 0, 0};
+                c[i] = entry;
+            }
+            int status = SCHED_OK;
+            if (policy == FCFS) status = csched::sched_fcfs(c.data(), n, workspace.data());
+            else if (policy == SJF) status = csched::sched_sjf(c.data(), n, workspace.data());
+            else if (policy == RR) status = csched::sched_round_robin(c.data(), n, quantum, workspace.data());
+            else status = csched::sched_priority(c.data(), n, workspace.data());
+
+            vector<Process> input = policy == FCFS ? byArrival(processes) : processes;
+            vector<Process> expected = runEngine(input, (Policy)policy, quantum, SwitchCostModel());
+            vector<int> completion(n + 1), waiting(n + 1);
+            for (const auto& process : expected) {
+                completion[process.id] = process.completionTime;
+                waiting[process.id] = process.waitingTime;
+            }
+            bool same = status == SCHED_OK;
+            for (int i = 0; i < n && same; i++) {
+                same = c[i].id == processes[i].id && c[i].completion_time == completion[c[i].id] &&
+                       c[i].waiting_time == waiting[c[i].id] &&
+                       c[i].turnaround_time == c[i].completion_time - c[i].arrival_time;
+            }
+            check(same, string("C ") + policyNames[policy] + " vs C++ engine, round " + to_string(round));
+        }
+    }
+    csched::Process one = {1, 0, 1, 0, 0, 0, 0};
+    check(csched::sched_round_robin(&one, 1, 0, workspace.data()) == SCHED_EINVAL, "C Round Robin rejects quantum 0");
+}
+
+template <typename Key>
+static void checkRadixSort(mt19937_64& rng, int n, Key range, int threads) {
+    vector<Key> keys(n);
+    for (auto& key : keys) key = range == 0 ? (Key)rng() : (Key)(rng() % range);
+    vector<int> expected(n);
+    iota(expected.begin(), expected.end(), 0);
+    stable_sort(expected.begin(), expected.end(), [&](int a, int b) { return keys[a] < keys[b]; });
+
+    SimulationContext::Scope scratch;
+    vector<int> order(n);
+    RadixSort::sortIndices(keys.data(), n, order.data(), threads);
+    check(order == expected, "RadixSort<" + to_string(sizeof(Key) * 8) + "-bit> n=" + to_string(n) + " range=" +
+                                 to_string((unsigned long long)range) + " threads=" + to_string(threads));
+}
+
+static void testRadixSort() {
+    mt19937_64 rng(3);
+    int sizes[] = {0, 1, 2, 255, 256, 5000, 100000};
+    for (int n : sizes) {
+        checkRadixSort<uint32_t>(rng, n, 0, 1);
+        checkRadixSort<uint32_t>(rng, n, 7, 1);            // few distinct keys: stability matters
+        checkRadixSort<uint32_t>(rng, n, 1u << 20, 1);     // top byte shared by every key
+        checkRadixSort<uint64_t>(rng, n, 0, 1);
+        checkRadixSort<uint64_t>(rng, n, 1000000, 1);
+    }
+    // the threaded path starts at PARALLEL_MIN keys
+    checkRadixSort<uint32_t>(rng, RadixSort::PARALLEL_MIN + 12345, 1000, 4);
+    checkRadixSort<uint64_t>(rng, RadixSort::PARALLEL_MIN + 12345, 0, 3);
+
+    mt19937 small(42);
+    for (int n : {0, 1, 7, RADIX_SORT_MIN - 1, RADIX_SORT_MIN, RADIX_SORT_MIN + 1, 20000}) {
+        for (int range : {1, 10, 1 << 30}) {
+            vector<Process> processes(n);
+            for (int i = 0; i < n; i++) processes[i].arrivalTime = (int)(small() % range) - range / 2;
+            for (bool presorted : {false, true}) {
+                if (presorted) processes = byArrival(processes);
+                vector<int> expected(n);
+                iota(expected.begin(), expected.end(), 0);
+                stable_sort(expected.begin(), expected.end(), [&](int a, int b) {
+                    return processes[a].arrivalTime < processes[b].arrivalTime;
+                });
+                SimulationContext::Scope scratch;
+                const int* order = sortedByArrival(processes);
+                check(equal(expected.begin(), expected.end(), order),
+                      "sortedByArrival vs stable_sort, " + to_string(n) + " jobs, range " + to_string(range) +
+                          (presorted ? ", presorted" : ""));
+            }
+        }
+    }
+}
+
+static bool sameRecords(const vector<Process>& a, const vector<Process>& b) {
+    if (!sameTiming(a, b)) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].turnaroundTime != b[i].turnaroundTime || a[i].switchTime != b[i].switchTime ||
+            a[i].cacheRefillTime != b[i].cacheRefillTime || a[i].remainingTime != b[i].remainingTime) {
+            return false;
+        }
+    }
+    return true;
+}
+
+class SliceCollector : public SliceSink {
+public:
+    vector<string> runs;
+    vector<vector<GanttEntry>> slices;   // per run
+    size_t count = 0;
+
+    void beginRun(const char* engine) {
+        runs.push_back(engine);
+        slices.push_back(vector<GanttEntry>());
+    }
+    void slice(const GanttEntry& entry) {
+        slices.back().push_back(entry);
+        count++;
+    }
+};
+
+static size_t occurrences(const string& text, const string& pattern) {
+    size_t count = 0;
+    for (size_t at = text.find(pattern); at != string::npos; at = text.find(pattern, at + 1)) count++;
+    return count;
+}
+
+static void testTrace() {
+    mt19937 rng(35);
+    vector<Process> processes = workload(rng, 6000, 4, 10);
+    SwitchCostModel cost(1, 2, 5);
+    vector<Process> plainRr = CPUScheduler::roundRobin(processes, 2, cost);
+    vector<Process> plainCfs = CPUScheduler::cfs(processes, 6, 1, cost);
+
+    SliceCollector collector;
+    SliceSink::active() = &collector;
+    vector<Process> rr = CPUScheduler::roundRobin(processes, 2, cost);
+    vector<Process> cfs = CPUScheduler::cfs(processes, 6, 1, cost);
+    SliceSink::active() = 0;
+    check(sameTiming(rr, plainRr) && sameTiming(cfs, plainCfs), "tracing leaves the results alone");
+    check(collector.runs.size() == 2, "one trace run per engine run");
+
+    // per job, run slices add up to the burst and switch slices to the overhead
+    map<int, long long> ran, switching;
+    bool ordered = true;
+    for (const vector<GanttEntry>& run : collector.slices) {
+        long long lastEnd = 0;
+        for (const GanttEntry& entry : run) {
+            (entry.isSwitch ? switching : ran)[entry.processId] += entry.endTime - entry.startTime;
+            ordered = ordered && entry.startTime >= lastEnd && entry.endTime >= entry.startTime;
+            lastEnd = entry.endTime;
+        }
+    }
+    long long bursts = 0, overhead = 0, tracedRun = 0, tracedSwitch = 0;
+    for (size_t i = 0; i < processes.size(); i++) {
+        bursts += 2LL * processes[i].burstTime;
+        overhead += rr[i].switchOverhead() + cfs[i].switchOverhead();
+    }
+    for (const auto& job : ran) tracedRun += job.second;
+    for (const auto& job : switching) tracedSwitch += job.second;
+    check(tracedRun == bursts && tracedSwitch == overhead, "slices add up to bursts and switch overhead");
+    check(ordered, "slices in time order within each run");
+
+    const char* path = "engine_tests_trace.json";
+    {
+        TraceWriter writer;   // more than one buffer of output
+        check(writer.open(path), "trace file opens");
+        SliceSink::active() = &writer;
+        CPUScheduler::roundRobin(processes, 2, cost);
+        CPUScheduler::cfs(processes, 6, 1, cost);
+        SliceSink::active() = 0;
+    }
+    ifstream in(path);
+    string json((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    in.close();
+    remove(path);
+    check(json.size() > TraceWriter::BUFFER_SIZE && json.compare(0, 17, "{\"traceEvents\": [") == 0 &&
+              json.compare(json.size() - 4, 4, "\n]}\n") == 0,
+          "trace JSON is one complete traceEvents array");
+    check(occurrences(json, "\"ph\": \"X\"") == collector.count &&
+              occurrences(json, "\"process_name\"") == 2 && occurrences(json, "\"thread_name\"") == 2,
+          "trace JSON has one event per slice and names each run and core");
+}
+
+static void testParallelFcfs() {
+    mt19937 rng(33);
+    const int chunk = 65536;   // parallelFcfs splits only into chunks at least this long
+    for (int n : {0, 1, 1000, 2 * chunk + 17, 5 * chunk + 3}) {
+        for (bool sorted : {true, false}) {
+            vector<Process> processes;
+            int arrival = 0;
+            for (int i = 0; i < n; i++) {
+                arrival += rng() % 3;
+                processes.push_back(Process(i + 1, sorted ? arrival : rng() % (3 * n + 1), 1 + rng() % 10));
+            }
+            SwitchCostModel cost(rng() % 3, rng() % 4, rng() % 5);
+            vector<Process> serial = CPUScheduler::fcfs(processes, cost);
+            for (int threads : {1, 2, 3, 8}) {
+                check(sameRecords(CPUScheduler::parallelFcfs(processes, threads, cost), serial),
+                      "parallel FCFS on " + to_string(threads) + " threads vs serial, " + to_string(n) +
+                          (sorted ? " sorted" : " unsorted") + " jobs");
+            }
+        }
+    }
+}
+
+static void testCheckpoint() {
+    const char* path = "engine_tests_checkpoint.bin";
+    mt19937 rng(31);
+    vector<Process> processes;
+    int arrival = 0;
+    for (int i = 0; i < 3000; i++) {
+        arrival += rng() % 4;
+        int deadline = rng() % 3 == 0 ? 5 + rng() % 20 : 0, period = i < 30 ? 20 + rng() % 50 : 0;
+        processes.push_back(Process(i + 1, arrival, 1 + rng() % 9, (int)(rng() % 40) - 20, deadline, period));
+    }
+    SwitchCostModel cost(1, 3, 50);
+
+    // a resumed run picks up the last snapshot the first run wrote
+    vector<Process> cfs = CPUScheduler::cfs(processes, 6, 1, cost);
+    for (long long interval : {500LL, 7000LL, 12345LL}) {
+        CheckpointOptions checkpoint;
+        checkpoint.path = path;
+        checkpoint.interval = interval;
+        vector<Process> saving = CPUScheduler::cfs(processes, 6, 1, cost, checkpoint);
+        checkpoint.resume = true;
+        vector<Process> resumed = CPUScheduler::cfs(processes, 6, 1, cost, checkpoint);
+        check(sameRecords(saving, cfs) && sameRecords(resumed, cfs),
+              "CFS resumed every " + to_string(interval) + " vs uninterrupted");
+    }
+
+    vector<Process> periodic(processes.begin(), processes.begin() + 40);
+    const int horizon = 20000;
+    DeadlineStats uninterrupted;
+    vector<Process> edf = CPUScheduler::edf(periodic, horizon, uninterrupted, cost);
+    for (long long interval : {1000LL, 9000LL, 15001LL}) {
+        CheckpointOptions checkpoint;
+        checkpoint.path = path;
+        checkpoint.interval = interval;
+        DeadlineStats saving, resumed;
+        vector<Process> first = CPUScheduler::edf(periodic, horizon, saving, cost, checkpoint);
+        checkpoint.resume = true;
+        vector<Process> second = CPUScheduler::edf(periodic, horizon, resumed, cost, checkpoint);
+        check(sameRecords(first, edf) && sameRecords(second, edf) && resumed.instances == uninterrupted.instances &&
+                  resumed.misses == uninterrupted.misses && resumed.totalLateness == uninterrupted.totalLateness,
+              "EDF resumed every " + to_string(interval) + " vs uninterrupted");
+    }
+
+    BurstTable bursts = burstTable(rng, processes.size(), 2);
+    for (int kind = 0; kind < 3; kind++) {
+        UtilizationStats expectedStats;
+        vector<Process> expected = CPUScheduler::burstSequences(processes, bursts, 2, POLICY_RR, 3, expectedStats,
+                                                                cost, (EventQueueKind)kind);
+        for (long long interval : {500LL, 6000LL, 9001LL}) {
+            CheckpointOptions checkpoint;
+            checkpoint.path = path;
+            checkpoint.interval = interval;
+            UtilizationStats saving, resumed;
+            vector<Process> first = CPUScheduler::burstSequences(processes, bursts, 2, POLICY_RR, 3, saving, cost,
+                                                                 (EventQueueKind)kind, checkpoint);
+            checkpoint.resume = true;
+            vector<Process> second = CPUScheduler::burstSequences(processes, bursts, 2, POLICY_RR, 3, resumed, cost,
+                                                                  (EventQueueKind)kind, checkpoint);
+            check(sameRecords(first, expected) && sameRecords(second, expected) &&
+                      resumed.cpuBusy == expectedStats.cpuBusy && resumed.deviceBusy == expectedStats.deviceBusy &&
+                      resumed.deviceQueueWait == expectedStats.deviceQueueWait,
+                  "bursts on event queue " + to_string(kind) + " resumed every " + to_string(interval));
+        }
+    }
+
+    // the snapshot now belongs to the burst run: CFS must start over, not load it
+    CheckpointOptions foreign;
+    foreign.path = path;
+    foreign.resume = true;
+    check(sameRecords(CPUScheduler::cfs(processes, 6, 1, cost, foreign), cfs), "CFS ignores a foreign snapshot");
+    remove(path);
+}
+
+static void testReadyQueues() {
+    mt19937 rng(38);
+    for (int round = 0; round < 40; round++) {
+        SimulationContext::Scope scratch;
+        int n = 1 + rng() % 3000, range = round % 2 ? 8 : 1 << 30;
+        KeyedQueue<ShortestBurst> keyed(n);
+        BucketQueue<ShortestBurst> buckets(n);
+        vector<Process> jobs(n);
+        vector<int> idle(n);
+        iota(idle.begin(), idle.end(), 0);
+        int order = 0, queued = 0;
+        bool same = true;
+        for (int step = 0; step < 20 * n && same; step++) {
+            if (!idle.empty() && (queued == 0 || rng() % 3 != 0)) {
+                swap(idle[rng() % idle.size()], idle.back());
+                int job = idle.back();
+                idle.pop_back();
+                jobs[job].burstTime = (int)(rng() % range) - range / 2;
+                keyed.push(job, jobs[job], order);
+                buckets.push(job, jobs[job], order++);
+                queued++;
+            } else {
+                int job = keyed.pop();
+                same = buckets.pop() == job;
+                idle.push_back(job);
+                queued--;
+            }
+        }
+        while (same && !keyed.empty()) same = !buckets.empty() && buckets.pop() == keyed.pop();
+        check(same && buckets.empty(), "BucketQueue vs KeyedQueue, round " + to_string(round));
+    }
+}
+
+template <typename Engine>
+static void checkOnline(const char* name, Engine& engine, const vector<Process>& processes, bool arrivalOrder,
+                        const vector<Process>& batch, int round) {
+    vector<Process> online = processes;
+    replayOnline(engine, online, arrivalOrder);   // the console's driver
+    vector<int> completion(processes.size() + 1), waiting(processes.size() + 1);
+    for (const auto& process : batch) {
+        completion[process.id] = process.completionTime;
+        waiting[process.id] = process.waitingTime;
+    }
+    bool same = true;
+    for (const auto& process : online) {
+        same = same && completion[process.id] == process.completionTime && waiting[process.id] == process.waitingTime;
+    }
+    check(same, string("online ") + name + " vs batch engine, round " + to_string(round));
+    check(engine.metrics().completed == (long long)processes.size(), string("online ") + name + " completed count");
+}
+
+static void testOnline() {
+    mt19937 rng(4);
+    for (int round = 0; round < 20; round++) {
+        int n = 1 + rng() % 2000, quantum = 1 + rng() % 6;
+        // equal keys go to the earlier submission online but to the lower
+        // index in batch, which agree when input order is arrival order
+        vector<Process> processes = byArrival(workload(rng, n, 1 + rng() % 15, 1 + rng() % 12));
+        SwitchCostModel cost(round % 3, round % 2 ? 2 : 0, 20);
+        {
+            OnlineFcfs engine(n, RunToCompletion(), cost);
+            checkOnline("FCFS", engine, processes, true, runEngine(processes, FCFS, 0, cost), round);
+        }
+        {
+            OnlineSjf engine(n, RunToCompletion(), cost);
+            checkOnline("SJF", engine, processes, false, runEngine(processes, SJF, 0, cost), round);
+        }
+        {
+            OnlineRoundRobin engine(n, QuantumExpiry(quantum), cost);
+            checkOnline("Round Robin", engine, processes, false, runEngine(processes, RR, quantum, cost), round);
+        }
+        {
+            OnlinePriority engine(n, RunToCompletion(), cost);
+            checkOnline("Priority", engine, processes, false, runEngine(processes, PRIORITY, 0, cost), round);
+        }
+        {
+            // a stateful rule: only right if the engine forwards queued()/dispatching()
+            SimulationContext::Scope scratch;
+            int maxBurst = 0;
+            for (const auto& process : processes) maxBurst = max(maxBurst, process.burstTime);
+            vector<Process> batch = processes;
+            AdaptiveRoundRobinEngine::run(batch, 50, cost);
+            OnlineEngine<FifoQueue, AdaptiveQuantum> engine(n, AdaptiveQuantum(maxBurst, 50), cost);
+            checkOnline("Adaptive Round Robin", engine, processes, false, batch, round);
+        }
+    }
+
+    OnlineFcfs engine(2);
+    int first = engine.submit(Process(1, 0, 5)), second = engine.submit(Process(2, 0, 5));
+    engine.next(0);
+    bool thrown = false;
+    try {
+        engine.complete(second, 5);
+    } catch (const logic_error&) {
+        thrown = true;
+    }
+    check(thrown && engine.metrics().completed == 0 && engine.queued() == 1, "online complete() of a queued job");
+    check(engine.complete(first, 5).completionTime == 5, "online complete() of the running job");
+}
+
+static void testMonteCarlo() {
+    WorkloadModel model(30, 4.0, 5.0);
+    MonteCarloOptions options;
+    options.minReplications = 30;
+    options.maxReplications = 600;
+    options.relativePrecision = 0.05;
+    options.threads = 1;
+    MonteCarlo::Result serial = MonteCarlo::run(model, options);
+    for (int threads : {2, 3, 4, 7}) {
+        options.threads = threads;
+        MonteCarlo::Result parallel = MonteCarlo::run(model, options);
+        bool same = parallel.replications == serial.replications && parallel.converged == serial.converged;
+        for (int a = 0; a < MonteCarlo::ALGORITHM_COUNT; a++) {
+            for (int m = 0; m < MonteCarlo::METRIC_COUNT; m++) {
+                same = same && parallel.stats[a][m].mean == serial.stats[a][m].mean &&
+                       parallel.stats[a][m].m2 == serial.stats[a][m].m2;
+            }
+        }
+        check(same, "Monte Carlo on " + to_string(threads) + " threads vs 1");
+    }
+    check(serial.replications % options.minReplications == 0, "Monte Carlo stops at a whole round");
+}
+
+static const char* TRACE_FILE = "engine_tests_trace.txt";
+
+static bool loadTrace(const vector<string>& lines, int cpu, FtraceImporter::Result& result) {
+    {
+        ofstream out(TRACE_FILE);
+        for (const string& line : lines) out << line << "\n";
+    }
+    bool loaded = FtraceImporter::load(TRACE_FILE, cpu, result);
+    remove(TRACE_FILE);
+    return loaded;
+}
+
+static void testFtrace() {
+    const string wake = ": sched_wakeup: comm=job pid=100 prio=120 target_cpu=000";
+    const string in = ": sched_switch: prev_comm=swapper prev_pid=0 prev_prio=120 prev_state=R ==> "
+                      "next_comm=job next_pid=100 next_prio=120";
+    const string out = ": sched_switch: prev_comm=job prev_pid=100 prev_prio=120 prev_state=S ==> "
+                       "next_comm=swapper next_pid=0 next_prio=120";
+    // runs 10-50, sleeps until 80, runs 90-100: bursts 40, 30, 10 and 20 us of waiting
+    vector<string> lines = {
+        "<idle>-0 [000] 1.000000" + wake, "<idle>-0 [000] 1.000010" + in, "job-100 [000] 1.000050" + out,
+        "<idle>-0 [000] 1.000080" + wake, "<idle>-0 [000] 1.000090" + in, "job-100 [000] 1.000100" + out};
+    FtraceImporter::Result trace;
+    check(loadTrace(lines, -1, trace) && trace.processes.size() == 1 && trace.cpus == 1,
+          "ftrace single-CPU trace loads");
+    if (trace.processes.size() == 1) {
+        const Process& job = trace.processes[0];
+        vector<int> bursts(trace.bursts.lengths.begin() + trace.bursts.offsets[0],
+                           trace.bursts.lengths.begin() + trace.bursts.offsets[1]);
+        check(job.id == 100 && job.arrivalTime == 0 && job.burstTime == 50 && trace.observedWaiting[0] == 20,
+              "ftrace job totals");
+        check(bursts == vector<int>({40, 30, 10}), "ftrace burst sequence");
+    }
+
+    // another task switching on CPU 1 makes a two-CPU trace unless CPU 0 is picked
+    lines.push_back("<idle>-0 [001] 1.000120: sched_switch: prev_comm=swapper prev_pid=0 prev_prio=120 "
+                    "prev_state=R ==> next_comm=other next_pid=200 next_prio=120");
+    check(loadTrace(lines, -1, trace) && trace.cpus == 2, "ftrace counts both CPUs");
+    check(loadTrace(lines, 0, trace) && trace.cpus == 1 && trace.processes.size() == 1, "ftrace keeps CPU 0 only");
+
+    lines.push_back("<idle>-0 [000] 4000.000000" + wake);   // past 2^31 us from the first event
+    bool thrown = false;
+    try {
+        loadTrace(lines, 0, trace);
+    } catch (const overflow_error&) {
+        thrown = true;
+    }
+    remove(TRACE_FILE);
+    check(thrown, "ftrace rejects a trace past the 32-bit limit");
+}
+
+// Cores in use never exceed `cores`; a gang's cores free at its completion.
+static bool withinCores(const vector<Process>& processes, int cores) {
+    vector<pair<long long, int>> changes;
+    for (const Process& process : processes) {
+        int width = min(max(process.threads, 1), cores);
+        changes.push_back(make_pair((long long)process.firstRunTime, width));
+        changes.push_back(make_pair((long long)process.completionTime, -width));
+    }
+    sort(changes.begin(), changes.end());   // releases sort before starts at the same time
+    int busy = 0;
+    for (const pair<long long, int>& change : changes) {
+        busy += change.second;
+        if (busy > cores) return false;
+    }
+    return true;
+}
+
+static void testGang() {
+    // 2 of 4 cores busy until 10, a 4-wide gang waits for them; the 2-wide
+    // job behind it fits now and ends by 10, so only backfilling runs it early
+    vector<Process> small = {Process(1, 0, 10), Process(2, 1, 5), Process(3, 2, 5)};
+    small[0].threads = 2;
+    small[1].threads = 4;
+    small[2].threads = 2;
+    GangStats stats;
+    vector<Process> plain = CPUScheduler::gang(small, 4, false, stats);
+    check(plain[1].firstRunTime == 10 && plain[2].firstRunTime == 15 && stats.backfilled == 0,
+          "Gang without backfill starts in arrival order");
+    vector<Process> filled = CPUScheduler::gang(small, 4, true, stats);
+    check(filled[1].firstRunTime == 10 && filled[2].firstRunTime == 2 && stats.backfilled == 1,
+          "Gang backfill runs the short job without delaying the head");
+
+    mt19937 rng(43);
+    for (int round = 0; round < 200; round++) {
+        int cores = 1 + rng() % 8;
+        vector<Process> processes = workload(rng, 1 + rng() % 40, rng() % 6, 20);
+        for (Process& process : processes) process.threads = 1 + rng() % (cores + 2);
+        GangStats fcfsStats, backfillStats;
+        vector<Process> fcfs = CPUScheduler::gang(processes, cores, false, fcfsStats);
+        vector<Process> backfill = CPUScheduler::gang(processes, cores, true, backfillStats);
+        string tag = " (round " + to_string(round) + ")";
+        check(withinCores(fcfs, cores) && withinCores(backfill, cores), "Gang core capacity" + tag);
+
+        vector<Process> ordered = byArrival(fcfs);
+        bool inOrder = true;
+        for (size_t i = 1; i < ordered.size(); i++) {
+            inOrder = inOrder && ordered[i - 1].firstRunTime <= ordered[i].firstRunTime;
+        }
+        check(inOrder, "Gang without backfill starts in arrival order" + tag);
+
+        // EASY: the oldest waiting gang is never pushed back by a backfilled one
+        check(byArrival(backfill)[0].firstRunTime == ordered[0].firstRunTime, "Gang backfill keeps the first start" + tag);
+        check(fcfsStats.busyCoreTime == backfillStats.busyCoreTime, "Gang busy core time" + tag);
+    }
+}
+
+static void testCluster() {
+    mt19937 rng(44);
+    for (int round = 0; round < 60; round++) {
+        vector<Process> processes = workload(rng, 1 + rng() % 60, rng() % 8, 15);
+        int quantum = 1 + rng() % 4;
+        SwitchCostModel cost(rng() % 2, rng() % 3, 1 + rng() % 4);
+        string tag = " (round " + to_string(round) + ")";
+
+        ClusterOptions options;
+        options.nodes = 1;
+        options.timeQuantum = quantum;
+        options.costModel = cost;
+        options.threads = 1;
+        for (int policy = FCFS; policy <= PRIORITY; policy++) {
+            options.policy = (CpuPolicy)policy;
+            ClusterStats stats;
+            vector<Process> cluster = ClusterSimulator::run(processes, options, stats);
+            vector<Process> input = policy == FCFS ? byArrival(processes) : processes;
+            check(sameTiming(byId(cluster), byId(runEngine(input, (Policy)policy, quantum, cost))),
+                  string("One-node cluster vs ") + policyNames[policy] + tag);
+        }
+
+        options.nodes = 1 + rng() % 12;
+        options.policy = (CpuPolicy)(rng() % 4);
+        options.dispatch = (DispatchRule)(rng() % 3);
+        options.migrate = rng() % 2 != 0;
+        options.syncInterval = 1 + rng() % 20;
+        options.threads = 1;
+        ClusterStats serialStats;
+        vector<Process> serial = ClusterSimulator::run(processes, options, serialStats);
+        for (int threads : {2, 3, 8}) {
+            options.threads = threads;
+            ClusterStats stats;
+            vector<Process> parallel = ClusterSimulator::run(processes, options, stats);
+            check(sameTiming(parallel, serial) && stats.nodeBusy == serialStats.nodeBusy &&
+                      stats.nodeJobs == serialStats.nodeJobs && stats.migrations == serialStats.migrations,
+                  "Cluster on " + to_string(threads) + " threads vs 1" + tag);
+        }
+    }
+
+    ClusterOptions options;
+    options.policy = POLICY_RR;
+    options.timeQuantum = 0;
+    ClusterStats stats;
+    bool thrown = false;
+    try {
+        ClusterSimulator::run(workload(rng, 5, 2, 5), options, stats);
+    } catch (const invalid_argument&) {
+        thrown = true;
+    }
+    check(thrown, "Cluster rejects a zero Round Robin quantum");
+}
+
+static void testEnergy() {
+    mt19937 rng(45);
+    for (int round = 0; round < 60; round++) {
+        vector<Process> processes = workload(rng, 1 + rng() % 60, rng() % 12, 15);
+        int quantum = 1 + rng() % 4;
+        string tag = " (round " + to_string(round) + ")";
+        for (int policy = FCFS; policy <= PRIORITY; policy++) {
+            string name = string(policyNames[policy]) + tag;
+            EnergyStats perf, aware;
+            vector<Process> fast = CPUScheduler::energyAware(processes, (CpuPolicy)policy, quantum, DvfsModel(),
+                                                             GOVERNOR_PERFORMANCE, perf);
+            vector<Process> input = policy == FCFS ? byArrival(processes) : processes;
+            check(sameTiming(byId(fast), byId(runEngine(input, (Policy)policy, quantum, SwitchCostModel()))),
+                  "DVFS at full speed vs the engine, " + name);
+
+            DvfsModel dvfs;
+            dvfs.maxStretch = 0.5;
+            CPUScheduler::energyAware(processes, (CpuPolicy)policy, quantum, dvfs, GOVERNOR_ENERGY_AWARE, aware);
+            check(aware.joules() <= perf.joules() + 1e-9, "Energy-aware uses no more energy, " + name);
+            check(accumulate(aware.levelTime.begin(), aware.levelTime.end(), 0LL) == aware.busyTime &&
+                      aware.busyTime <= aware.makespan,
+                  "Energy-aware level time adds up, " + name);
+        }
+    }
+
+    EnergyStats stats;
+    bool thrown = false;
+    try {
+        CPUScheduler::energyAware(workload(rng, 5, 2, 5), POLICY_RR, 0, DvfsModel(), GOVERNOR_PERFORMANCE, stats);
+    } catch (const invalid_argument&) {
+        thrown = true;
+    }
+    check(thrown, "DVFS rejects a zero Round Robin quantum");
+}
+
+static const struct Suite {
+    const char* name;
+    void (*run)();
+} suites[] = {
+    {"cfs", testCfs},
+    {"realtime", testRealTime},
+    {"bursts", testBursts},
+    {"predictor", testPredictor},
+    {"metrics", testMetrics},
+    {"event_queue", testEventQueues},
+    {"adaptive_rr", testAdaptiveRoundRobin},
+    {"typedefs", testTypedefs},
+    {"c_library", testCLibrary},
+    {"radix_sort", testRadixSort},
+    {"trace", testTrace},
+    {"parallel_fcfs", testParallelFcfs},
+    {"checkpoint", testCheckpoint},
+    {"ready_queue", testReadyQueues},
+    {"online", testOnline},
+    {"monte_carlo", testMonteCarlo},
+    {"ftrace", testFtrace},
+    {"gang", testGang},
+    {"cluster", testCluster},
+    {"energy", testEnergy},
+};
+
+int main(int argc, char* argv[]) {
+    string suite = argc > 1 ? argv[1] : "all";
+    bool known = false;
+    for (const Suite& entry : suites) {
+        if (suite == "all" || suite == entry.name) {
+            entry.run();
+            known = true;
+        }
+    }
+    if (!known) {
+        cout << "Unknown suite: " << suite << " (or all)\n";
+        return 2;
+    }
+    cout << suite << ": " << (failures == 0 ? "passed" : to_string(failures) + " failed") << "\n";
+    return failures == 0 ? 0 : 1;
+}